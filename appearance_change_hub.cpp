@@ -0,0 +1,90 @@
+#include "ui_extension.h"
+
+namespace cui {
+
+appearance_change_hub& appearance_change_hub::s_get()
+{
+    static appearance_change_hub hub;
+    return hub;
+}
+
+appearance_change_hub::appearance_change_hub()
+{
+    register_common_callback<fonts::manager>(std::make_shared<font_callback>());
+    register_common_callback<colours::manager>(std::make_shared<colour_callback>());
+}
+
+callback_token::ptr appearance_change_hub::subscribe(callback_t callback, HWND wnd)
+{
+    auto subscriber_ptr = std::make_shared<subscriber>(subscriber{std::move(callback), wnd});
+    m_subscribers.emplace_back(subscriber_ptr);
+
+    return fb2k::service_new<lambda_callback_token>(
+        [subscriber_ptr{std::move(subscriber_ptr)}] { s_get().unsubscribe(subscriber_ptr); });
+}
+
+void appearance_change_hub::post_changes(const appearance_changes& changes)
+{
+    if (changes.is_empty() || m_subscribers.empty() || is_shut_down())
+        return;
+
+    for (auto& subscriber_ptr : m_subscribers)
+        subscriber_ptr->pending_changes |= changes;
+
+    if (m_is_delivery_queued)
+        return;
+
+    m_is_delivery_queued = true;
+    fb2k::inMainThread([] { s_get().flush(); });
+}
+
+void appearance_change_hub::flush()
+{
+    m_is_delivery_queued = false;
+
+    // Subscribers may subscribe or unsubscribe from their callbacks
+    const auto subscribers = m_subscribers;
+    std::vector<HWND> windows_to_repaint;
+
+    for (auto& subscriber_ptr : subscribers) {
+        if (!subscriber_ptr->is_subscribed || subscriber_ptr->pending_changes.is_empty())
+            continue;
+
+        const auto changes = std::exchange(subscriber_ptr->pending_changes, {});
+        subscriber_ptr->callback(changes);
+
+        if (subscriber_ptr->wnd && subscriber_ptr->is_subscribed)
+            windows_to_repaint.emplace_back(subscriber_ptr->wnd);
+    }
+
+    std::vector<HWND> root_windows;
+
+    for (const auto wnd : windows_to_repaint) {
+        if (!IsWindow(wnd))
+            continue;
+
+        RedrawWindow(wnd, nullptr, nullptr, RDW_INVALIDATE | RDW_ERASE | RDW_FRAME | RDW_ALLCHILDREN);
+
+        const auto root_window = GetAncestor(wnd, GA_ROOT);
+
+        if (root_window && std::ranges::find(root_windows, root_window) == root_windows.end())
+            root_windows.emplace_back(root_window);
+    }
+
+    for (const auto root_window : root_windows)
+        RedrawWindow(root_window, nullptr, nullptr, RDW_UPDATENOW | RDW_ALLCHILDREN);
+}
+
+void appearance_change_hub::on_shutdown()
+{
+    for (auto& subscriber_ptr : m_subscribers)
+        subscriber_ptr->pending_changes = {};
+}
+
+void appearance_change_hub::unsubscribe(const std::shared_ptr<subscriber>& subscriber_ptr)
+{
+    subscriber_ptr->is_subscribed = false;
+    std::erase(m_subscribers, subscriber_ptr);
+}
+
+} // namespace cui
@@ -0,0 +1,124 @@
+#pragma once
+
+namespace cui {
+
+/**
+ * \brief Merged appearance changes delivered by appearance_change_hub.
+ */
+struct appearance_changes {
+    /** Combination of fonts::font_type_flag_t values for common fonts that changed. */
+    uint32_t font_mask{};
+
+    /** Combination of colours::colour_flag_t values for global colours that changed. */
+    uint32_t colour_mask{};
+
+    /** Combination of colours::bool_flag_t values for global boolean flags that changed. */
+    uint32_t bool_mask{};
+
+    [[nodiscard]] bool is_empty() const { return !font_mask && !colour_mask && !bool_mask; }
+
+    [[nodiscard]] bool is_dark_mode_change() const { return (bool_mask & colours::bool_flag_dark_mode_enabled) != 0; }
+
+    appearance_changes& operator|=(const appearance_changes& other)
+    {
+        font_mask |= other.font_mask;
+        colour_mask |= other.colour_mask;
+        bool_mask |= other.bool_mask;
+        return *this;
+    }
+};
+
+/**
+ * \brief Delivers common font, colour and boolean flag changes to subscribers once per message loop turn.
+ *
+ * When several appearance items change at once (for example, when switching between light and dark mode), Columns
+ * UI notifies common callbacks several times. The hub merges these notifications, and delivers one
+ * appearance_changes notification to each subscriber on the next turn of the main thread message loop.
+ *
+ * If a window is passed when subscribing, the hub invalidates it after all subscribers have been notified, and then
+ * updates each affected top-level window once. This means that the whole frame is repainted in a single pass rather
+ * than once for every panel. Subscribers passing a window should therefore only invalidate any cached state in their
+ * callback, and not repaint the window themselves.
+ *
+ * The hub stops listening for changes when foobar2000 is shutting down, and queued changes are then discarded.
+ *
+ * \note This class must only be used from the main thread.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * m_appearance_token = cui::appearance_change_hub::s_get().subscribe(
+ *     [this](const cui::appearance_changes& changes) {
+ *         if (changes.font_mask & cui::fonts::font_type_flag_items)
+ *             recreate_font();
+ *         if (changes.is_dark_mode_change())
+ *             update_scroll_bar_theme();
+ *     },
+ *     get_wnd());
+ * \endcode
+ */
+class appearance_change_hub final : public shared_cache_base {
+public:
+    using callback_t = std::function<void(const appearance_changes& changes)>;
+
+    static appearance_change_hub& s_get();
+
+    /**
+     * Subscribe to appearance changes.
+     *
+     * \param callback  function called with merged changes
+     * \param wnd       window to invalidate and repaint after notifying subscribers, or `nullptr`
+     * \return          token that should be reset to unsubscribe
+     */
+    [[nodiscard]] callback_token::ptr subscribe(callback_t callback, HWND wnd = nullptr);
+
+    /**
+     * Queue changes for delivery to all subscribers.
+     *
+     * This can be used to forward changes received from other sources (for example, a colour client) so that they
+     * are merged with changes to common fonts and colours.
+     */
+    void post_changes(const appearance_changes& changes);
+
+    /** Deliver queued changes immediately, rather than on the next message loop turn. */
+    void flush();
+
+private:
+    struct subscriber {
+        callback_t callback;
+        HWND wnd{};
+        appearance_changes pending_changes;
+        bool is_subscribed{true};
+    };
+
+    class font_callback : public fonts::common_callback {
+    public:
+        void on_font_changed(uint32_t changed_items_mask) const override
+        {
+            s_get().post_changes({changed_items_mask, 0, 0});
+        }
+    };
+
+    class colour_callback : public colours::common_callback {
+    public:
+        void on_colour_changed(uint32_t changed_items_mask) const override
+        {
+            s_get().post_changes({0, changed_items_mask, 0});
+        }
+
+        void on_bool_changed(uint32_t changed_items_mask) const override
+        {
+            s_get().post_changes({0, 0, changed_items_mask});
+        }
+    };
+
+    appearance_change_hub();
+    ~appearance_change_hub() override { shutdown(); }
+
+    void on_shutdown() override;
+    void unsubscribe(const std::shared_ptr<subscriber>& subscriber_ptr);
+
+    std::vector<std::shared_ptr<subscriber>> m_subscribers;
+    bool m_is_delivery_queued{};
+};
+
+} // namespace cui
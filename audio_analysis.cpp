@@ -0,0 +1,178 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+namespace {
+
+class audio_analysis_initquit : public initquit {
+public:
+    void on_quit() noexcept override { audio_analysis::s_get().shutdown(); }
+};
+
+initquit_factory_t<audio_analysis_initquit> g_audio_analysis_initquit;
+
+} // namespace
+
+audio_analysis& audio_analysis::s_get()
+{
+    static audio_analysis analysis;
+    return analysis;
+}
+
+cui::callback_token::ptr audio_analysis::add_client()
+{
+    if (m_client_count++ == 0)
+        start();
+
+    return fb2k::service_new<cui::lambda_callback_token>([] { s_get().remove_client(); });
+}
+
+const audio_analysis_snapshot& audio_analysis::get_snapshot()
+{
+    m_snapshots.update();
+    return m_snapshots.get_front_buffer();
+}
+
+void audio_analysis::set_interval(std::chrono::milliseconds interval)
+{
+    m_interval_ms.store(std::max(interval.count(), int64_t{1}), std::memory_order_relaxed);
+}
+
+void audio_analysis::shutdown()
+{
+    m_is_shut_down = true;
+    stop();
+}
+
+void audio_analysis::start()
+{
+    if (m_is_shut_down)
+        return;
+
+    visualisation_manager::ptr api;
+    if (!fb2k::std_api_try_get(api))
+        return;
+
+    api->create_stream(m_stream, visualisation_manager::KStreamFlagNewFFT);
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop_requested = false;
+    }
+
+    m_last_time = -1.0;
+    m_thread = std::thread([this] { run(); });
+}
+
+void audio_analysis::stop()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop_requested = true;
+    }
+
+    m_stop_condition.notify_all();
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    m_stream.release();
+}
+
+void audio_analysis::remove_client()
+{
+    if (--m_client_count == 0)
+        stop();
+}
+
+void audio_analysis::run()
+{
+    audio_chunk_impl chunk;
+
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            const auto interval = std::chrono::milliseconds(m_interval_ms.load(std::memory_order_relaxed));
+
+            if (m_stop_condition.wait_for(lock, interval, [this] { return m_stop_requested; }))
+                break;
+        }
+
+        if (analyse(m_snapshots.get_back_buffer(), chunk))
+            m_snapshots.publish();
+    }
+}
+
+bool audio_analysis::analyse(audio_analysis_snapshot& snapshot, audio_chunk_impl& chunk)
+{
+    double time{};
+
+    if (!m_stream->get_absolute_time(time)) {
+        if (m_last_time < 0.0)
+            return false;
+
+        // Publish an invalid snapshot once, so that clients know playback has stopped
+        m_last_time = -1.0;
+        snapshot.sequence = ++m_sequence;
+        snapshot.is_valid = false;
+        return true;
+    }
+
+    if (time == m_last_time)
+        return false;
+
+    if (!m_stream->get_spectrum_absolute(chunk, time, fft_size))
+        return false;
+
+    m_last_time = time;
+
+    const auto channel_count = chunk.get_channel_count();
+    const auto bin_count = chunk.get_sample_count();
+    const auto spectrum_data = chunk.get_data();
+
+    snapshot.sequence = ++m_sequence;
+    snapshot.is_valid = true;
+    snapshot.time = time;
+    snapshot.sample_rate = chunk.get_sample_rate();
+    snapshot.channel_count = channel_count;
+    snapshot.spectrum.assign(bin_count, 0.0f);
+
+    for (size_t bin{}; bin < bin_count; ++bin) {
+        audio_sample sum{};
+
+        for (size_t channel{}; channel < channel_count; ++channel)
+            sum += spectrum_data[bin * channel_count + channel];
+
+        snapshot.spectrum[bin] = channel_count > 0 ? static_cast<float>(sum / channel_count) : 0.0f;
+    }
+
+    snapshot.channel_peaks.assign(channel_count, 0.0f);
+    snapshot.channel_rms.assign(channel_count, 0.0f);
+
+    const auto length = static_cast<double>(m_interval_ms.load(std::memory_order_relaxed)) / 1000.0;
+
+    if (!m_stream->get_chunk_absolute(chunk, time, length) || chunk.get_channel_count() != channel_count)
+        return true;
+
+    const auto sample_count = chunk.get_sample_count();
+    const auto sample_data = chunk.get_data();
+
+    for (size_t channel{}; channel < channel_count; ++channel) {
+        audio_sample peak{};
+        double sum_of_squares{};
+
+        for (size_t sample{}; sample < sample_count; ++sample) {
+            const auto value = sample_data[sample * channel_count + channel];
+            peak = std::max(peak, static_cast<audio_sample>(std::abs(value)));
+            sum_of_squares += static_cast<double>(value) * value;
+        }
+
+        snapshot.channel_peaks[channel] = static_cast<float>(peak);
+        snapshot.channel_rms[channel]
+            = sample_count > 0 ? static_cast<float>(std::sqrt(sum_of_squares / sample_count)) : 0.0f;
+    }
+
+    return true;
+}
+
+} // namespace uie
@@ -0,0 +1,155 @@
+#pragma once
+
+namespace uie {
+
+/**
+ * \brief Lock-free triple buffer for passing the latest value of an object from one thread to another.
+ *
+ * The producer writes to get_back_buffer() and calls publish(). The consumer calls update() and then reads
+ * get_front_buffer(). Neither side ever waits for the other, and the consumer always sees the most recently
+ * published value.
+ *
+ * \note There must be only one producer thread and one consumer thread.
+ */
+template <class Value>
+class triple_buffer {
+public:
+    /** Get the buffer to write the next value to. Producer only. */
+    [[nodiscard]] Value& get_back_buffer() { return m_buffers[m_back_index]; }
+
+    /** Publish the value in the back buffer. Producer only. */
+    void publish()
+    {
+        m_back_index = m_middle.exchange(m_back_index | new_value_flag, std::memory_order_acq_rel) & index_mask;
+    }
+
+    /**
+     * Make the most recently published value available through get_front_buffer(). Consumer only.
+     *
+     * \return whether a new value was published since the last call
+     */
+    bool update()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & new_value_flag))
+            return false;
+
+        m_front_index = m_middle.exchange(m_front_index, std::memory_order_acq_rel) & index_mask;
+        return true;
+    }
+
+    /** Get the most recent value made available by update(). Consumer only. */
+    [[nodiscard]] const Value& get_front_buffer() const { return m_buffers[m_front_index]; }
+
+private:
+    static constexpr uint8_t index_mask = 0x3;
+    static constexpr uint8_t new_value_flag = 0x4;
+
+    std::array<Value, 3> m_buffers{};
+    uint8_t m_back_index{0};
+    std::atomic<uint8_t> m_middle{1};
+    uint8_t m_front_index{2};
+};
+
+/**
+ * \brief Result of a shared audio analysis pass.
+ */
+struct audio_analysis_snapshot {
+    /** Incremented each time a new chunk of audio is analysed. */
+    uint64_t sequence{};
+
+    /** Whether audio data was available. If false, the other members are not meaningful. */
+    bool is_valid{};
+
+    /** Playback time of the analysed audio, in seconds. */
+    double time{};
+
+    unsigned sample_rate{};
+    unsigned channel_count{};
+
+    /** Magnitudes of the spectrum (of size audio_analysis::fft_size / 2), averaged across channels. */
+    std::vector<float> spectrum;
+
+    /** Peak absolute sample value of each channel. */
+    std::vector<float> channel_peaks;
+
+    /** Root mean square sample value of each channel. */
+    std::vector<float> channel_rms;
+};
+
+/**
+ * \brief Analyses playing audio once for all visualisations in a module.
+ *
+ * While at least one client is registered, a worker thread reads audio from a foobar2000 visualisation stream,
+ * and computes the spectrum (using the core's windowed FFT) and the peak and RMS values of each channel once for
+ * each new chunk of audio. Results are published through a triple_buffer, so reading the latest snapshot never
+ * blocks the analysis thread (or vice versa).
+ *
+ * \note add_client() and get_snapshot() must only be called from the main thread. Snapshot references remain valid
+ * until the next call to get_snapshot().
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * // visualisation::enable()
+ * m_analysis_token = uie::audio_analysis::s_get().add_client();
+ *
+ * // Each frame
+ * const auto& snapshot = uie::audio_analysis::s_get().get_snapshot();
+ *
+ * if (snapshot.is_valid)
+ *     draw_bars(snapshot.spectrum);
+ *
+ * // visualisation::disable()
+ * m_analysis_token.release();
+ * \endcode
+ */
+class audio_analysis {
+public:
+    static constexpr unsigned fft_size = 1024;
+    static constexpr auto default_interval = std::chrono::milliseconds(10);
+
+    static audio_analysis& s_get();
+
+    /**
+     * Register a client. Analysis runs while at least one client is registered.
+     *
+     * \return token that should be released when the client no longer needs analysis results
+     */
+    [[nodiscard]] cui::callback_token::ptr add_client();
+
+    /** Get the latest analysis results. */
+    [[nodiscard]] const audio_analysis_snapshot& get_snapshot();
+
+    /**
+     * Set how often the worker thread checks for new audio.
+     *
+     * \param interval  interval between checks
+     */
+    void set_interval(std::chrono::milliseconds interval);
+
+    /** Stop analysing audio. Called automatically when foobar2000 is shutting down. */
+    void shutdown();
+
+private:
+    audio_analysis() = default;
+    ~audio_analysis() { stop(); }
+
+    void start();
+    void stop();
+    void remove_client();
+    void run();
+    bool analyse(audio_analysis_snapshot& snapshot, audio_chunk_impl& chunk);
+
+    size_t m_client_count{};
+    bool m_is_shut_down{};
+    visualisation_stream::ptr m_stream;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_stop_condition;
+    bool m_stop_requested{};
+    std::atomic<int64_t> m_interval_ms{default_interval.count()};
+    double m_last_time{-1.0};
+    uint64_t m_sequence{};
+    triple_buffer<audio_analysis_snapshot> m_snapshots;
+};
+
+} // namespace uie
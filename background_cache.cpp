@@ -0,0 +1,132 @@
+#include "ui_extension.h"
+
+namespace uie::win32 {
+
+namespace {
+
+// The version must be incremented if background_cache::window_property changes
+constexpr auto background_cache_prop_name = L"uie_win32_background_cache_v2";
+
+} // namespace
+
+void background_cache::attach(HWND wnd)
+{
+    detach();
+
+    m_wnd = wnd;
+    SetProp(m_wnd, background_cache_prop_name, &m_window_property);
+
+    if (fb2k::std_api_try_get(m_colours_api))
+        m_colours_api->register_common_callback(this);
+}
+
+void background_cache::detach()
+{
+    if (m_colours_api.is_valid()) {
+        m_colours_api->deregister_common_callback(this);
+        m_colours_api.release();
+    }
+
+    if (m_wnd) {
+        RemoveProp(m_wnd, background_cache_prop_name);
+        m_wnd = nullptr;
+    }
+
+    m_bitmap.release();
+    m_is_valid = false;
+}
+
+bool background_cache::paint_child_background(HWND wnd_child, HDC dc)
+{
+    if (!m_wnd || m_is_rendering)
+        return false;
+
+    RECT client_rect{};
+    GetClientRect(m_wnd, &client_rect);
+
+    const auto origin = get_origin();
+
+    if (!m_is_valid || !m_bitmap.is_size({client_rect.right, client_rect.bottom}) || origin.x != m_origin.x
+        || origin.y != m_origin.y) {
+        if (!render())
+            return false;
+    }
+
+    RECT child_rect{};
+    GetClientRect(wnd_child, &child_rect);
+    MapWindowPoints(wnd_child, m_wnd, reinterpret_cast<LPPOINT>(&child_rect), 2);
+
+    return BitBlt(dc, 0, 0, child_rect.right - child_rect.left, child_rect.bottom - child_rect.top, m_bitmap.get_dc(),
+               child_rect.left, child_rect.top, SRCCOPY)
+        != 0;
+}
+
+bool background_cache::s_paint_child_background(HWND wnd, HWND wnd_child, HDC dc)
+{
+    const auto property = static_cast<const window_property*>(GetProp(wnd, background_cache_prop_name));
+
+    if (!property || !property->paint_child_background)
+        return false;
+
+    return property->paint_child_background(property->context, wnd_child, dc) != FALSE;
+}
+
+background_cache* background_cache::s_get(HWND wnd)
+{
+    const auto property = static_cast<const window_property*>(GetProp(wnd, background_cache_prop_name));
+
+    if (!property || property->paint_child_background != &s_on_paint_child_background)
+        return nullptr;
+
+    return static_cast<background_cache*>(property->context);
+}
+
+BOOL WINAPI background_cache::s_on_paint_child_background(void* context, HWND wnd_child, HDC dc)
+{
+    // Exceptions must not be propagated to other modules
+    try {
+        return static_cast<background_cache*>(context)->paint_child_background(wnd_child, dc);
+    } catch (const std::exception&) {
+        return FALSE;
+    }
+}
+
+bool background_cache::render()
+{
+    RECT client_rect{};
+    GetClientRect(m_wnd, &client_rect);
+
+    if (client_rect.right <= 0 || client_rect.bottom <= 0)
+        return false;
+
+    const auto wnd_dc = GetDC(m_wnd);
+    const auto is_bitmap_created = m_bitmap.create(wnd_dc, {client_rect.right, client_rect.bottom});
+    ReleaseDC(m_wnd, wnd_dc);
+
+    if (!is_bitmap_created) {
+        m_is_valid = false;
+        return false;
+    }
+
+    m_is_rendering = true;
+    auto _ = fb2k::callOnRelease([this] { m_is_rendering = false; });
+
+    if (m_render_background)
+        m_render_background(m_wnd, m_bitmap.get_dc());
+    else
+        SendMessage(m_wnd, WM_ERASEBKGND, reinterpret_cast<WPARAM>(m_bitmap.get_dc()), 0);
+
+    m_origin = get_origin();
+    m_is_valid = true;
+    return true;
+}
+
+POINT background_cache::get_origin() const
+{
+    // The background may be painted by any ancestor window, so the position relative to the top-level window is used
+    auto origin = POINT{0, 0};
+    MapWindowPoints(m_wnd, GetAncestor(m_wnd, GA_ROOT), &origin, 1);
+    return origin;
+}
+
+} // namespace uie::win32
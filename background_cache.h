@@ -0,0 +1,127 @@
+#pragma once
+
+namespace uie::win32 {
+
+/**
+ * \brief Caches the background of a window, so that transparent child windows can copy it instead of asking the
+ * window to paint its background every time.
+ *
+ * This is useful for windows hosting many transparent child windows (or nested transparent containers), as it stops
+ * the background of every ancestor window being repainted for every child window.
+ *
+ * Call attach() after creating the window. uie::win32::paint_background_using_parent() will then copy the relevant
+ * part of the cached background when called for a direct child of the window, including child windows belonging to
+ * other components.
+ *
+ * The cached background is re-rendered when the size of the window changes, when the window moves relative to its
+ * top-level window (for example, because an ancestor window was moved), and when Columns UI colours or the dark mode
+ * status change. Call invalidate() if the background changes for any other reason (for example, on
+ * `WM_SYSCOLORCHANGE` or `WM_THEMECHANGED`).
+ *
+ * \note Only use this if the background of the window does not depend on what is drawn by its child windows.
+ */
+class background_cache final : cui::colours::common_callback {
+public:
+    /**
+     * Function used to render the background of the window.
+     *
+     * \param wnd  the window
+     * \param dc   device context to render the background to
+     */
+    using render_background_t = std::function<void(HWND wnd, HDC dc)>;
+
+    /**
+     * \param render_background  function used to render the background of the window. If empty, the background
+     *                           is rendered by sending the window a `WM_ERASEBKGND` message.
+     */
+    explicit background_cache(render_background_t render_background = nullptr)
+        : m_render_background(std::move(render_background))
+    {
+    }
+
+    ~background_cache() { detach(); }
+
+    background_cache(const background_cache&) = delete;
+    background_cache& operator=(const background_cache&) = delete;
+
+    /**
+     * Start caching the background of a window.
+     *
+     * \param wnd  the window
+     */
+    void attach(HWND wnd);
+
+    /**
+     * Stop caching the background of the window, and free the cached background.
+     *
+     * This must be called before the window is destroyed, if the background_cache instance is not destroyed first.
+     */
+    void detach();
+
+    /** Discard the cached background, so that it's re-rendered the next time it's used. */
+    void invalidate() const { m_is_valid = false; }
+
+    /**
+     * Paint the background of a child window using the cached background.
+     *
+     * \param wnd_child  direct child window of the window being cached
+     * \param dc         device context of the child window
+     * \return           whether the background was painted
+     */
+    bool paint_child_background(HWND wnd_child, HDC dc);
+
+    /**
+     * Paint the background of a child window using the background cache attached to its parent, if there is one.
+     *
+     * This works with background caches attached by other components.
+     *
+     * \param wnd        window that may have a background cache attached
+     * \param wnd_child  direct child window of wnd
+     * \param dc         device context of the child window
+     * \return           whether the background was painted
+     */
+    static bool s_paint_child_background(HWND wnd, HWND wnd_child, HDC dc);
+
+    /**
+     * Get the background_cache instance attached to a window by this module.
+     *
+     * \param wnd  the window
+     * \return     the attached instance, or `nullptr` if there is none or it was attached by another module
+     */
+    static background_cache* s_get(HWND wnd);
+
+private:
+    /**
+     * Data stored in a window property of the window being cached.
+     *
+     * Other modules only use the function pointer, so that they don't depend on the layout of background_cache. If
+     * this structure changes, the name of the window property must also be changed.
+     */
+    struct window_property {
+        BOOL(WINAPI* paint_child_background)(void* context, HWND wnd_child, HDC dc){};
+        void* context{};
+    };
+
+    static BOOL WINAPI s_on_paint_child_background(void* context, HWND wnd_child, HDC dc);
+
+    void on_colour_changed(uint32_t changed_items_mask) const override { invalidate(); }
+    void on_bool_changed(uint32_t changed_items_mask) const override
+    {
+        if (changed_items_mask & cui::colours::bool_flag_dark_mode_enabled)
+            invalidate();
+    }
+
+    bool render();
+    POINT get_origin() const;
+
+    HWND m_wnd{};
+    window_property m_window_property{&s_on_paint_child_background, this};
+    retained_bitmap m_bitmap;
+    POINT m_origin{};
+    bool m_is_rendering{};
+    mutable bool m_is_valid{};
+    render_background_t m_render_background;
+    cui::colours::manager::ptr m_colours_api;
+};
+
+} // namespace uie::win32
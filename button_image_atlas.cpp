@@ -0,0 +1,532 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+namespace {
+
+struct bitmap_pixels {
+    long width{};
+    long height{};
+    std::vector<uint32_t> pixels;
+};
+
+/** Get the pixels of a bitmap as top-down 32-bit BGRA. */
+std::optional<bitmap_pixels> get_bitmap_pixels(HBITMAP bitmap)
+{
+    BITMAP bitmap_info{};
+
+    if (!bitmap || !GetObject(bitmap, sizeof(bitmap_info), &bitmap_info) || bitmap_info.bmWidth <= 0
+        || bitmap_info.bmHeight == 0)
+        return {};
+
+    const auto width = bitmap_info.bmWidth;
+    const auto height = std::abs(bitmap_info.bmHeight);
+
+    BITMAPINFO dib_info{};
+    dib_info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    dib_info.bmiHeader.biWidth = width;
+    dib_info.bmiHeader.biHeight = -height;
+    dib_info.bmiHeader.biPlanes = 1;
+    dib_info.bmiHeader.biBitCount = 32;
+    dib_info.bmiHeader.biCompression = BI_RGB;
+
+    bitmap_pixels result{width, height, std::vector<uint32_t>(static_cast<size_t>(width) * height)};
+
+    const auto dc = GetDC(nullptr);
+    const auto lines_copied = GetDIBits(dc, bitmap, 0, height, result.pixels.data(), &dib_info, DIB_RGB_COLORS);
+    ReleaseDC(nullptr, dc);
+
+    if (lines_copied != height)
+        return {};
+
+    return result;
+}
+
+bool has_alpha(const bitmap_pixels& image)
+{
+    return std::ranges::any_of(image.pixels, [](uint32_t pixel) { return (pixel >> 24) != 0; });
+}
+
+void set_opaque(bitmap_pixels& image)
+{
+    for (auto& pixel : image.pixels)
+        pixel |= 0xff000000;
+}
+
+void premultiply(bitmap_pixels& image)
+{
+    for (auto& pixel : image.pixels) {
+        const auto alpha = pixel >> 24;
+
+        if (alpha == 0xff)
+            continue;
+
+        const auto blue = (pixel & 0xff) * alpha / 0xff;
+        const auto green = ((pixel >> 8) & 0xff) * alpha / 0xff;
+        const auto red = ((pixel >> 16) & 0xff) * alpha / 0xff;
+
+        pixel = (alpha << 24) | (red << 16) | (green << 8) | blue;
+    }
+}
+
+/** Apply a monochrome mask, where white pixels are transparent. */
+void apply_mask_bitmap(bitmap_pixels& image, HBITMAP mask)
+{
+    const auto mask_pixels = get_bitmap_pixels(mask);
+
+    if (!mask_pixels || mask_pixels->width != image.width || mask_pixels->height < image.height) {
+        set_opaque(image);
+        return;
+    }
+
+    for (size_t index{}; index < image.pixels.size(); ++index) {
+        const auto is_transparent = (mask_pixels->pixels[index] & 0xffffff) != 0;
+        image.pixels[index] = is_transparent ? 0 : image.pixels[index] | 0xff000000;
+    }
+}
+
+void apply_mask_colour(bitmap_pixels& image, COLORREF mask_colour)
+{
+    // COLORREF is 0x00BBGGRR, while DIB pixels are 0xAARRGGBB
+    const uint32_t mask_pixel
+        = (GetRValue(mask_colour) << 16) | (GetGValue(mask_colour) << 8) | GetBValue(mask_colour);
+
+    for (auto& pixel : image.pixels)
+        pixel = (pixel & 0xffffff) == mask_pixel ? 0 : pixel | 0xff000000;
+}
+
+std::optional<bitmap_pixels> get_icon_pixels(HICON icon)
+{
+    ICONINFO icon_info{};
+
+    if (!GetIconInfo(icon, &icon_info))
+        return {};
+
+    auto image = get_bitmap_pixels(icon_info.hbmColor);
+
+    if (image && !has_alpha(*image))
+        apply_mask_bitmap(*image, icon_info.hbmMask);
+
+    if (icon_info.hbmColor)
+        DeleteObject(icon_info.hbmColor);
+
+    if (icon_info.hbmMask)
+        DeleteObject(icon_info.hbmMask);
+
+    return image;
+}
+
+std::optional<bitmap_pixels> load_button_image(const button_image_key& key, const button::ptr& button)
+{
+    std::optional<bitmap_pixels> image;
+
+    if (button_v2::ptr button_v2; button->service_query_t(button_v2)) {
+        unsigned handle_type{};
+        const auto handle = button_v2->get_item_bitmap(
+            key.command_state_index, key.cr_btntext, key.cx_hint, key.cy_hint, handle_type);
+
+        if (!handle)
+            return {};
+
+        if (handle_type == button_v2::handle_type_icon) {
+            const auto icon = static_cast<HICON>(handle);
+            image = get_icon_pixels(icon);
+            DestroyIcon(icon);
+        } else {
+            const auto bitmap = static_cast<HBITMAP>(handle);
+            image = get_bitmap_pixels(bitmap);
+            DeleteObject(bitmap);
+
+            if (image && !has_alpha(*image))
+                set_opaque(*image);
+        }
+    } else {
+        auto mask_type = MASK_NONE;
+        COLORREF mask_colour{};
+        HBITMAP mask_bitmap{};
+        const auto bitmap
+            = button->get_item_bitmap(key.command_state_index, key.cr_btntext, mask_type, mask_colour, mask_bitmap);
+
+        image = get_bitmap_pixels(bitmap);
+
+        if (image) {
+            if (mask_type == MASK_BITMAP)
+                apply_mask_bitmap(*image, mask_bitmap);
+            else if (mask_type == MASK_COLOUR)
+                apply_mask_colour(*image, mask_colour);
+            else
+                set_opaque(*image);
+        }
+
+        if (bitmap)
+            DeleteObject(bitmap);
+
+        if (mask_bitmap)
+            DeleteObject(mask_bitmap);
+    }
+
+    if (!image)
+        return {};
+
+    premultiply(*image);
+    return image;
+}
+
+} // namespace
+
+button_image_atlas& button_image_atlas::s_get()
+{
+    static button_image_atlas atlas;
+    return atlas;
+}
+
+button_image_atlas::button_image_atlas(size_t max_pages) : m_max_pages(std::max(max_pages, size_t{1}))
+{
+    register_common_callback<cui::colours::manager>(std::make_shared<colour_callback>(*this));
+}
+
+std::optional<button_image> button_image_atlas::get_image(const button_image_key& key, const button::ptr& button)
+{
+    if (is_shut_down())
+        return {};
+
+    if (m_is_clear_pending)
+        clear();
+
+    if (const auto iter = m_index.find(key); iter != m_index.end()) {
+        ++m_stats.hits;
+        m_entries.splice(m_entries.begin(), m_entries, iter->second);
+
+        const auto& image_slot = iter->second->image_slot;
+
+        if (!image_slot)
+            return {};
+
+        return button_image{m_pages[image_slot->page_index].dc, image_slot->rect};
+    }
+
+    if (button.is_empty())
+        return {};
+
+    ++m_stats.misses;
+
+    std::optional<slot> image_slot;
+
+    if (const auto image = load_button_image(key, button)) {
+        image_slot = allocate({image->width, image->height});
+
+        if (!image_slot)
+            return {};
+
+        copy_to_page(*image_slot, image->pixels.data());
+    }
+
+    // Buttons without an image are also remembered, so that the button isn't asked again
+    m_entries.emplace_front(entry{key, image_slot});
+    m_index.emplace(key, m_entries.begin());
+
+    if (!image_slot)
+        return {};
+
+    return button_image{m_pages[image_slot->page_index].dc, image_slot->rect};
+}
+
+bool button_image_atlas::draw(
+    HDC dc, const RECT& rect, const button_image_key& key, const button::ptr& button, BYTE alpha)
+{
+    const auto image = get_image(key, button);
+
+    if (!image)
+        return false;
+
+    const BLENDFUNCTION blend_function{AC_SRC_OVER, 0, alpha, AC_SRC_ALPHA};
+
+    return GdiAlphaBlend(dc, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, image->dc,
+               image->rect.left, image->rect.top, image->rect.right - image->rect.left,
+               image->rect.bottom - image->rect.top, blend_function)
+        != 0;
+}
+
+void button_image_atlas::invalidate(const GUID& item_guid)
+{
+    for (auto iter = m_entries.begin(); iter != m_entries.end();) {
+        if (iter->key.item_guid != item_guid) {
+            ++iter;
+            continue;
+        }
+
+        if (iter->image_slot)
+            release_slot(*iter->image_slot);
+
+        m_index.erase(iter->key);
+        iter = m_entries.erase(iter);
+    }
+}
+
+void button_image_atlas::clear()
+{
+    m_is_clear_pending = false;
+    m_index.clear();
+    m_entries.clear();
+    m_free_slots.clear();
+    release_pages();
+}
+
+button_image_atlas_stats button_image_atlas::get_stats() const
+{
+    auto stats = m_stats;
+    stats.image_count = m_entries.size();
+    stats.page_count = m_pages.size();
+    return stats;
+}
+
+std::optional<button_image_atlas::slot> button_image_atlas::allocate(SIZE size)
+{
+    const auto try_allocate = [this, size] {
+        auto new_slot = allocate_from_free_slots(size);
+        return new_slot ? new_slot : allocate_from_pages(size);
+    };
+
+    auto new_slot = try_allocate();
+
+    // Evict images only until there is enough space. Pages are reused once all their images have been evicted.
+    while (!new_slot && !m_entries.empty()) {
+        evict_least_recently_used();
+        new_slot = try_allocate();
+    }
+
+    if (!new_slot) {
+        // The image is larger than the existing pages, and no more pages can be created
+        m_free_slots.clear();
+        release_pages();
+        new_slot = allocate_from_pages(size);
+    }
+
+    if (new_slot)
+        ++m_pages[new_slot->page_index].image_count;
+
+    return new_slot;
+}
+
+std::optional<button_image_atlas::slot> button_image_atlas::allocate_from_free_slots(SIZE size)
+{
+    const auto get_area = [](const slot& free_slot) {
+        return (free_slot.rect.right - free_slot.rect.left) * (free_slot.rect.bottom - free_slot.rect.top);
+    };
+
+    auto best_fit = m_free_slots.end();
+
+    for (auto iter = m_free_slots.begin(); iter != m_free_slots.end(); ++iter) {
+        const auto fits
+            = iter->rect.right - iter->rect.left >= size.cx && iter->rect.bottom - iter->rect.top >= size.cy;
+
+        if (fits && (best_fit == m_free_slots.end() || get_area(*iter) < get_area(*best_fit)))
+            best_fit = iter;
+    }
+
+    if (best_fit == m_free_slots.end())
+        return {};
+
+    const auto free_slot = *best_fit;
+    m_free_slots.erase(best_fit);
+
+    const slot new_slot{free_slot.page_index,
+        {free_slot.rect.left, free_slot.rect.top, free_slot.rect.left + size.cx, free_slot.rect.top + size.cy}};
+
+    // Keep the unused parts of the free slot (to the right of and below the new slot) for other images
+    if (free_slot.rect.right > new_slot.rect.right)
+        m_free_slots.emplace_back(slot{free_slot.page_index,
+            {new_slot.rect.right, free_slot.rect.top, free_slot.rect.right, new_slot.rect.bottom}});
+
+    if (free_slot.rect.bottom > new_slot.rect.bottom)
+        m_free_slots.emplace_back(slot{free_slot.page_index,
+            {free_slot.rect.left, new_slot.rect.bottom, free_slot.rect.right, free_slot.rect.bottom}});
+
+    return new_slot;
+}
+
+std::optional<button_image_atlas::slot> button_image_atlas::allocate_from_pages(SIZE size)
+{
+    for (size_t page_index{}; page_index < m_pages.size(); ++page_index) {
+        auto& atlas_page = m_pages[page_index];
+
+        for (auto& page_shelf : atlas_page.shelves) {
+            if (page_shelf.height < size.cy || page_shelf.next_left + size.cx > atlas_page.size.cx)
+                continue;
+
+            const RECT rect{page_shelf.next_left, page_shelf.top, page_shelf.next_left + size.cx,
+                page_shelf.top + size.cy};
+            page_shelf.next_left += size.cx;
+            return slot{page_index, rect};
+        }
+
+        if (size.cx <= atlas_page.size.cx && atlas_page.next_shelf_top + size.cy <= atlas_page.size.cy) {
+            const auto top = atlas_page.next_shelf_top;
+            atlas_page.shelves.emplace_back(shelf{top, size.cy, size.cx});
+            atlas_page.next_shelf_top += size.cy;
+            return slot{page_index, {0, top, size.cx, top + size.cy}};
+        }
+    }
+
+    if (m_pages.size() >= m_max_pages || !create_page(size))
+        return {};
+
+    auto& new_page = m_pages.back();
+    new_page.shelves.emplace_back(shelf{0, size.cy, size.cx});
+    new_page.next_shelf_top = size.cy;
+    return slot{m_pages.size() - 1, {0, 0, size.cx, size.cy}};
+}
+
+bool button_image_atlas::create_page(SIZE size)
+{
+    const SIZE page_dimensions{std::max(size.cx, long{page_size}), std::max(size.cy, long{page_size})};
+
+    BITMAPINFO bitmap_info{};
+    bitmap_info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bitmap_info.bmiHeader.biWidth = page_dimensions.cx;
+    bitmap_info.bmiHeader.biHeight = -page_dimensions.cy;
+    bitmap_info.bmiHeader.biPlanes = 1;
+    bitmap_info.bmiHeader.biBitCount = 32;
+    bitmap_info.bmiHeader.biCompression = BI_RGB;
+
+    page new_page;
+    void* bits{};
+    new_page.dc = CreateCompatibleDC(nullptr);
+    new_page.bitmap = CreateDIBSection(nullptr, &bitmap_info, DIB_RGB_COLORS, &bits, nullptr, 0);
+
+    if (!new_page.dc || !new_page.bitmap) {
+        if (new_page.bitmap)
+            DeleteObject(new_page.bitmap);
+
+        if (new_page.dc)
+            DeleteDC(new_page.dc);
+
+        return false;
+    }
+
+    new_page.previous_bitmap = SelectObject(new_page.dc, new_page.bitmap);
+    new_page.bits = static_cast<uint32_t*>(bits);
+    new_page.size = page_dimensions;
+    m_pages.emplace_back(std::move(new_page));
+    return true;
+}
+
+void button_image_atlas::copy_to_page(const slot& image_slot, const uint32_t* pixels)
+{
+    const auto& atlas_page = m_pages[image_slot.page_index];
+    const auto width = image_slot.rect.right - image_slot.rect.left;
+    const auto height = image_slot.rect.bottom - image_slot.rect.top;
+
+    // Make sure GDI has finished any drawing to the page before writing to it directly
+    GdiFlush();
+
+    for (long row{}; row < height; ++row) {
+        const auto source = pixels + static_cast<size_t>(row) * width;
+        const auto destination = atlas_page.bits
+            + static_cast<size_t>(image_slot.rect.top + row) * atlas_page.size.cx + image_slot.rect.left;
+        std::copy_n(source, width, destination);
+    }
+}
+
+void button_image_atlas::evict_least_recently_used()
+{
+    auto& least_recently_used = m_entries.back();
+
+    if (least_recently_used.image_slot)
+        release_slot(*least_recently_used.image_slot);
+
+    m_index.erase(least_recently_used.key);
+    m_entries.pop_back();
+    ++m_stats.evictions;
+}
+
+void button_image_atlas::release_slot(const slot& image_slot)
+{
+    auto& atlas_page = m_pages[image_slot.page_index];
+
+    if (--atlas_page.image_count > 0) {
+        add_free_slot(image_slot);
+        return;
+    }
+
+    // The page is now empty, so its space can be reallocated from scratch
+    atlas_page.shelves.clear();
+    atlas_page.next_shelf_top = 0;
+    std::erase_if(m_free_slots, [&image_slot](const slot& free_slot) {
+        return free_slot.page_index == image_slot.page_index;
+    });
+}
+
+void button_image_atlas::add_free_slot(slot free_slot)
+{
+    auto& atlas_page = m_pages[free_slot.page_index];
+    auto& rect = free_slot.rect;
+
+    const auto shelf_iter = std::ranges::find_if(atlas_page.shelves, [&rect](const shelf& page_shelf) {
+        return rect.top >= page_shelf.top && rect.top < page_shelf.top + page_shelf.height;
+    });
+
+    if (shelf_iter == atlas_page.shelves.end()) {
+        m_free_slots.emplace_back(free_slot);
+        return;
+    }
+
+    const auto shelf_bottom = shelf_iter->top + shelf_iter->height;
+
+    // Merge with adjacent free slots in the same shelf, so that the space can be reused by larger images
+    while (true) {
+        const auto adjacent_slot = std::ranges::find_if(m_free_slots, [&](const slot& other) {
+            const auto& other_rect = other.rect;
+
+            if (other.page_index != free_slot.page_index || other_rect.top < shelf_iter->top
+                || other_rect.bottom > shelf_bottom)
+                return false;
+
+            const auto is_horizontally_adjacent = other_rect.top == rect.top && other_rect.bottom == rect.bottom
+                && (other_rect.right == rect.left || other_rect.left == rect.right);
+            const auto is_vertically_adjacent = other_rect.left == rect.left && other_rect.right == rect.right
+                && (other_rect.bottom == rect.top || other_rect.top == rect.bottom);
+
+            return is_horizontally_adjacent || is_vertically_adjacent;
+        });
+
+        if (adjacent_slot == m_free_slots.end())
+            break;
+
+        rect = {std::min(rect.left, adjacent_slot->rect.left), std::min(rect.top, adjacent_slot->rect.top),
+            std::max(rect.right, adjacent_slot->rect.right), std::max(rect.bottom, adjacent_slot->rect.bottom)};
+        m_free_slots.erase(adjacent_slot);
+    }
+
+    // Space at the end of a shelf is returned to the shelf, and empty shelves at the bottom of the page are removed,
+    // so that the space can be used for images of any height
+    const auto is_end_of_shelf = rect.top == shelf_iter->top && rect.bottom == shelf_bottom
+        && rect.right == shelf_iter->next_left;
+
+    if (!is_end_of_shelf) {
+        m_free_slots.emplace_back(free_slot);
+        return;
+    }
+
+    shelf_iter->next_left = rect.left;
+
+    while (!atlas_page.shelves.empty() && atlas_page.shelves.back().next_left == 0) {
+        atlas_page.next_shelf_top = atlas_page.shelves.back().top;
+        atlas_page.shelves.pop_back();
+    }
+}
+
+void button_image_atlas::release_pages()
+{
+    for (auto& atlas_page : m_pages) {
+        if (atlas_page.previous_bitmap)
+            SelectObject(atlas_page.dc, atlas_page.previous_bitmap);
+
+        DeleteObject(atlas_page.bitmap);
+        DeleteDC(atlas_page.dc);
+    }
+
+    m_pages.clear();
+}
+
+} // namespace uie
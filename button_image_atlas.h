@@ -0,0 +1,191 @@
+#pragma once
+
+namespace uie {
+
+/**
+ * \brief Identifies a button image in a button_image_atlas.
+ *
+ * The members correspond to the parameters of button::get_item_bitmap() and button_v2::get_item_bitmap().
+ */
+struct button_image_key {
+    GUID item_guid{};
+    /** Subcommand of a menu_button, or a null GUID for other buttons. */
+    GUID subcommand_guid{};
+    unsigned command_state_index{};
+    COLORREF cr_btntext{};
+    unsigned cx_hint{};
+    unsigned cy_hint{};
+
+    bool operator==(const button_image_key& other) const = default;
+};
+
+/** \brief Counters for a button_image_atlas. */
+struct button_image_atlas_stats {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+    size_t image_count{};
+    size_t page_count{};
+};
+
+/**
+ * \brief Location of an image in a button_image_atlas.
+ *
+ * The image is premultiplied 32-bit BGRA, suitable for use with `AlphaBlend()`.
+ *
+ * \note This is only valid until the atlas is next modified.
+ */
+struct button_image {
+    /** Memory device context with the page containing the image selected into it. */
+    HDC dc{};
+    /** Position of the image in the page. */
+    RECT rect{};
+};
+
+/**
+ * \brief Cache of button images, packed into a few large bitmaps.
+ *
+ * Images are obtained from button::get_item_bitmap() or button_v2::get_item_bitmap() the first time they're
+ * requested, and converted to premultiplied 32-bit bitmaps. They're then copied into shared pages, so that toolbars
+ * can draw them without keeping a bitmap or icon handle for each button.
+ *
+ * Once all pages are full, least recently used images are evicted until there is space for a new image. Space
+ * freed by evicted images is merged with adjacent free space and reused by images that fit in it, and a page is
+ * reused for images of any size once all its images have been evicted. All images are discarded when the dark mode
+ * status changes.
+ *
+ * All images are also discarded when foobar2000 is shutting down, or when shutdown() is called. get_image() and
+ * draw() then no longer load images.
+ *
+ * \note This class is not thread-safe, and should only be used from the main thread.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * const uie::button_image_key key{button->get_item_guid(), subcommand_guid, 0, text_colour, icon_width, icon_height};
+ * uie::button_image_atlas::s_get().draw(dc, icon_rect, key, button);
+ * \endcode
+ */
+class button_image_atlas final : public cui::shared_cache_base {
+public:
+    /** Width and height of each page, in pixels. Larger images are given their own page. */
+    static constexpr int page_size = 512;
+
+    /** Get the shared instance. */
+    static button_image_atlas& s_get();
+
+    /**
+     * \param max_pages  maximum number of pages to create before evicting images
+     */
+    explicit button_image_atlas(size_t max_pages = 4);
+    ~button_image_atlas() override { shutdown(); }
+
+    /**
+     * Get an image, loading it from the button if it's not in the atlas.
+     *
+     * \param key     the image
+     * \param button  button to load the image from if needed; may be empty if the image should not be loaded
+     * \return        location of the image, or an empty value if the button has no image or the atlas has been shut
+     *                down
+     */
+    std::optional<button_image> get_image(const button_image_key& key, const button::ptr& button);
+
+    /**
+     * Draw an image, loading it from the button if it's not in the atlas.
+     *
+     * The image is stretched to fit the rectangle if it's a different size.
+     *
+     * \param dc      device context to draw to
+     * \param rect    rectangle to draw the image in
+     * \param key     the image
+     * \param button  button to load the image from if needed
+     * \param alpha   constant alpha applied to the image, for example to draw disabled buttons
+     * \return        whether the image was drawn
+     */
+    bool draw(HDC dc, const RECT& rect, const button_image_key& key, const button::ptr& button, BYTE alpha = 255);
+
+    /**
+     * Discard all images of a button, for example after the image of a custom button has changed.
+     *
+     * \param item_guid  item GUID of the button
+     */
+    void invalidate(const GUID& item_guid);
+
+    /** Discard all images and free all pages. */
+    void clear();
+
+    [[nodiscard]] button_image_atlas_stats get_stats() const;
+
+private:
+    struct key_hasher {
+        size_t operator()(const button_image_key& value) const noexcept
+        {
+            static_assert(std::has_unique_object_representations_v<button_image_key>);
+            return std::hash<std::string_view>()(
+                std::string_view(reinterpret_cast<const char*>(&value), sizeof(button_image_key)));
+        }
+    };
+
+    struct shelf {
+        long top{};
+        long height{};
+        long next_left{};
+    };
+
+    struct page {
+        HDC dc{};
+        HBITMAP bitmap{};
+        HGDIOBJ previous_bitmap{};
+        uint32_t* bits{};
+        SIZE size{};
+        long next_shelf_top{};
+        std::vector<shelf> shelves;
+        size_t image_count{};
+    };
+
+    struct slot {
+        size_t page_index{};
+        RECT rect{};
+    };
+
+    struct entry {
+        button_image_key key;
+        /** Empty if the button has no image. */
+        std::optional<slot> image_slot;
+    };
+
+    class colour_callback : public cui::colours::common_callback {
+    public:
+        explicit colour_callback(button_image_atlas& atlas) : m_atlas(atlas) {}
+
+        void on_bool_changed(uint32_t changed_items_mask) const override
+        {
+            if (changed_items_mask & cui::colours::bool_flag_dark_mode_enabled)
+                m_atlas.m_is_clear_pending = true;
+        }
+
+    private:
+        button_image_atlas& m_atlas;
+    };
+
+    void on_shutdown() override { clear(); }
+
+    std::optional<slot> allocate(SIZE size);
+    std::optional<slot> allocate_from_free_slots(SIZE size);
+    std::optional<slot> allocate_from_pages(SIZE size);
+    bool create_page(SIZE size);
+    void copy_to_page(const slot& image_slot, const uint32_t* pixels);
+    void evict_least_recently_used();
+    void release_slot(const slot& image_slot);
+    void add_free_slot(slot free_slot);
+    void release_pages();
+
+    size_t m_max_pages{};
+    std::list<entry> m_entries;
+    std::unordered_map<button_image_key, std::list<entry>::iterator, key_hasher> m_index;
+    std::vector<page> m_pages;
+    std::vector<slot> m_free_slots;
+    button_image_atlas_stats m_stats;
+    bool m_is_clear_pending{};
+};
+
+} // namespace uie
@@ -0,0 +1,129 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+button_state_aggregator::button_registration::button_registration(
+    button_state_aggregator& aggregator, size_t id, button::ptr button)
+    : m_aggregator(aggregator)
+    , m_id(id)
+    , m_button(std::move(button))
+    , m_delivered_button_state(m_button->get_button_state())
+    , m_delivered_command_state_index(m_button->get_command_state_index())
+{
+    m_button->register_callback(*this);
+}
+
+button_state_aggregator::button_registration::~button_registration()
+{
+    m_button->deregister_callback(*this);
+}
+
+void button_state_aggregator::button_registration::on_button_state_change(unsigned p_new_state)
+{
+    m_pending_button_state = p_new_state;
+    m_aggregator.mark_dirty(*this);
+}
+
+void button_state_aggregator::button_registration::on_command_state_change(unsigned p_new_state)
+{
+    m_pending_command_state_index = p_new_state;
+    m_aggregator.mark_dirty(*this);
+}
+
+void button_state_aggregator::add_button(size_t id, const button::ptr& button)
+{
+    remove_button(id);
+    m_registrations.emplace_back(std::make_unique<button_registration>(*this, id, button));
+}
+
+void button_state_aggregator::remove_button(size_t id)
+{
+    const auto iter = std::ranges::find_if(
+        m_registrations, [id](const auto& registration) { return registration->m_id == id; });
+
+    if (iter == m_registrations.end())
+        return;
+
+    std::erase(m_dirty_registrations, iter->get());
+    m_registrations.erase(iter);
+}
+
+void button_state_aggregator::remove_all_buttons()
+{
+    m_dirty_registrations.clear();
+    m_registrations.clear();
+}
+
+void button_state_aggregator::flush()
+{
+    m_is_flush_scheduled = false;
+
+    if (m_dirty_registrations.empty())
+        return;
+
+    std::vector<button_state_change> changes;
+    changes.reserve(m_dirty_registrations.size());
+
+    for (const auto registration : m_dirty_registrations) {
+        button_state_change change{registration->m_id};
+
+        if (const auto button_state = std::exchange(registration->m_pending_button_state, std::nullopt);
+            button_state && *button_state != registration->m_delivered_button_state) {
+            change.button_state = button_state;
+            registration->m_delivered_button_state = *button_state;
+        }
+
+        if (const auto command_state_index = std::exchange(registration->m_pending_command_state_index, std::nullopt);
+            command_state_index && *command_state_index != registration->m_delivered_command_state_index) {
+            change.command_state_index = command_state_index;
+            registration->m_delivered_command_state_index = *command_state_index;
+        }
+
+        registration->m_is_dirty = false;
+
+        // States that flipped and flipped back since the last delivery are left out
+        if (change.button_state || change.command_state_index)
+            changes.emplace_back(change);
+    }
+
+    m_dirty_registrations.clear();
+
+    if (changes.empty())
+        return;
+
+    ++m_stats.flush_count;
+    m_stats.delivered_change_count += changes.size();
+
+    if (m_on_changes)
+        m_on_changes(changes);
+
+    if (m_wnd)
+        UpdateWindow(m_wnd);
+}
+
+void button_state_aggregator::mark_dirty(button_registration& registration)
+{
+    ++m_stats.notification_count;
+
+    if (!registration.m_is_dirty) {
+        registration.m_is_dirty = true;
+        m_dirty_registrations.emplace_back(&registration);
+    }
+
+    schedule_flush();
+}
+
+void button_state_aggregator::schedule_flush()
+{
+    if (m_is_flush_scheduled)
+        return;
+
+    m_is_flush_scheduled = true;
+
+    fb2k::inMainThread([weak_self{std::weak_ptr(m_self)}] {
+        if (const auto self = weak_self.lock())
+            (*self)->flush();
+    });
+}
+
+} // namespace uie
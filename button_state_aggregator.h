@@ -0,0 +1,134 @@
+#pragma once
+
+namespace uie {
+
+/** \brief A change of button state delivered by button_state_aggregator. */
+struct button_state_change {
+    /** Identifier the button was added with. */
+    size_t id{};
+    /** New button state (a combination of uie::t_button_state flags), if it changed. */
+    std::optional<unsigned> button_state;
+    /** New command state index, if it changed. */
+    std::optional<unsigned> command_state_index;
+};
+
+/** \brief Counters for a button_state_aggregator. */
+struct button_state_aggregator_stats {
+    /** Number of button_callback notifications received. */
+    uint64_t notification_count{};
+    /** Number of changes delivered to the host. */
+    uint64_t delivered_change_count{};
+    /** Number of times changes were delivered. */
+    uint64_t flush_count{};
+};
+
+/**
+ * \brief Batches button state changes for toolbar hosts.
+ *
+ * Registers a button_callback with each added button. Rather than the host handling every notification
+ * immediately, changes are collected and delivered together on the next turn of the main thread message loop (or when
+ * flush() is called).
+ *
+ * Multiple changes to the same button are merged, and buttons whose state ended up unchanged are left out. If a
+ * window is specified, it's updated once after changes are delivered, so that all affected buttons are repainted
+ * together.
+ *
+ * \note This class must only be used from the main thread.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * m_state_aggregator = std::make_unique<uie::button_state_aggregator>(
+ *     [this](std::span<const uie::button_state_change> changes) {
+ *         for (auto&& change : changes) {
+ *             if (change.button_state)
+ *                 set_toolbar_button_state(change.id, *change.button_state);
+ *         }
+ *     },
+ *     m_toolbar_wnd);
+ *
+ * for (size_t index{}; index < m_buttons.size(); ++index)
+ *     m_state_aggregator->add_button(index, m_buttons[index]);
+ * \endcode
+ */
+class button_state_aggregator {
+public:
+    /**
+     * Function called with changed button states.
+     *
+     * \param changes  the changes, at most one per button
+     */
+    using on_changes_t = std::function<void(std::span<const button_state_change> changes)>;
+
+    /**
+     * \param on_changes  function called with changed button states
+     * \param wnd         window to update after changes have been delivered, or nullptr
+     */
+    explicit button_state_aggregator(on_changes_t on_changes, HWND wnd = nullptr)
+        : m_on_changes(std::move(on_changes))
+        , m_wnd(wnd)
+    {
+    }
+
+    ~button_state_aggregator() { remove_all_buttons(); }
+
+    button_state_aggregator(const button_state_aggregator&) = delete;
+    button_state_aggregator& operator=(const button_state_aggregator&) = delete;
+
+    /**
+     * Start receiving state changes from a button.
+     *
+     * \param id      identifier passed back in button_state_change
+     * \param button  the button
+     */
+    void add_button(size_t id, const button::ptr& button);
+
+    /**
+     * Stop receiving state changes from a button. Pending changes for it are discarded.
+     *
+     * \param id  identifier the button was added with
+     */
+    void remove_button(size_t id);
+
+    /** Stop receiving state changes from all buttons. */
+    void remove_all_buttons();
+
+    /** Deliver pending changes now. */
+    void flush();
+
+    [[nodiscard]] button_state_aggregator_stats get_stats() const { return m_stats; }
+
+private:
+    class button_registration : public button_callback {
+    public:
+        button_registration(button_state_aggregator& aggregator, size_t id, button::ptr button);
+        ~button_registration();
+
+        button_registration(const button_registration&) = delete;
+        button_registration& operator=(const button_registration&) = delete;
+
+        void on_button_state_change(unsigned p_new_state) override;
+        void on_command_state_change(unsigned p_new_state) override;
+
+        button_state_aggregator& m_aggregator;
+        const size_t m_id;
+        const button::ptr m_button;
+        unsigned m_delivered_button_state{};
+        unsigned m_delivered_command_state_index{};
+        std::optional<unsigned> m_pending_button_state;
+        std::optional<unsigned> m_pending_command_state_index;
+        bool m_is_dirty{};
+    };
+
+    void mark_dirty(button_registration& registration);
+    void schedule_flush();
+
+    on_changes_t m_on_changes;
+    HWND m_wnd{};
+    std::vector<std::unique_ptr<button_registration>> m_registrations;
+    std::vector<button_registration*> m_dirty_registrations;
+    bool m_is_flush_scheduled{};
+    std::shared_ptr<button_state_aggregator*> m_self{std::make_shared<button_state_aggregator*>(this)};
+    button_state_aggregator_stats m_stats;
+};
+
+} // namespace uie
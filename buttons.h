@@ -227,6 +227,8 @@ public:
      *       mode status changes.
      *
      * \return Handle of image
+     *
+     * \see uie::button_image_atlas for caching images in hosts
      */
     virtual HANDLE get_item_bitmap(unsigned command_state_index, COLORREF cr_btntext, unsigned cx_hint,
         unsigned cy_hint, unsigned& handle_type) const = 0;
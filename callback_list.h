@@ -0,0 +1,359 @@
+#pragma once
+
+/**
+ * \file callback_list.h
+ * \brief Allocation-light callbacks and callback lists
+ *
+ * This header only depends on the standard library, so that it can be built and tested on other platforms.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cui {
+
+template <class Signature, size_t BufferSize = 3 * sizeof(void*)>
+class small_function;
+
+/**
+ * \brief Move-only function wrapper that stores small function objects without a heap allocation.
+ *
+ * Function objects up to BufferSize bytes in size (such as lambdas capturing a few pointers) are stored inline.
+ * Larger function objects are stored on the heap.
+ */
+template <class Result, class... Args, size_t BufferSize>
+class small_function<Result(Args...), BufferSize> {
+public:
+    small_function() = default;
+
+    template <class Func>
+        requires(!std::is_same_v<std::remove_cvref_t<Func>, small_function>
+            && std::is_invocable_r_v<Result, Func&, Args...>)
+    small_function(Func&& func)
+    {
+        using stored_type = std::remove_cvref_t<Func>;
+
+        if constexpr (s_is_stored_inline<stored_type>()) {
+            new (m_buffer) stored_type(std::forward<Func>(func));
+            m_operations = &s_inline_operations<stored_type>;
+        } else {
+            *reinterpret_cast<stored_type**>(m_buffer) = new stored_type(std::forward<Func>(func));
+            m_operations = &s_heap_operations<stored_type>;
+        }
+    }
+
+    small_function(small_function&& other) noexcept { move_from(other); }
+
+    small_function& operator=(small_function&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    small_function(const small_function&) = delete;
+    small_function& operator=(const small_function&) = delete;
+
+    ~small_function() { reset(); }
+
+    Result operator()(Args... args) const { return m_operations->invoke(m_buffer, std::forward<Args>(args)...); }
+
+    explicit operator bool() const noexcept { return m_operations != nullptr; }
+
+    void reset() noexcept
+    {
+        if (m_operations) {
+            m_operations->destroy(m_buffer);
+            m_operations = nullptr;
+        }
+    }
+
+private:
+    struct operations {
+        Result (*invoke)(void* buffer, Args&&... args);
+        void (*move)(void* source, void* destination) noexcept;
+        void (*destroy)(void* buffer) noexcept;
+    };
+
+    template <class Func>
+    static constexpr bool s_is_stored_inline()
+    {
+        return sizeof(Func) <= BufferSize && alignof(Func) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Func>;
+    }
+
+    template <class Func>
+    static constexpr operations s_inline_operations{
+        [](void* buffer, Args&&... args) -> Result {
+            return std::invoke(*static_cast<Func*>(buffer), std::forward<Args>(args)...);
+        },
+        [](void* source, void* destination) noexcept {
+            new (destination) Func(std::move(*static_cast<Func*>(source)));
+            static_cast<Func*>(source)->~Func();
+        },
+        [](void* buffer) noexcept { static_cast<Func*>(buffer)->~Func(); },
+    };
+
+    template <class Func>
+    static constexpr operations s_heap_operations{
+        [](void* buffer, Args&&... args) -> Result {
+            return std::invoke(**static_cast<Func**>(buffer), std::forward<Args>(args)...);
+        },
+        [](void* source, void* destination) noexcept {
+            *static_cast<Func**>(destination) = *static_cast<Func**>(source);
+        },
+        [](void* buffer) noexcept { delete *static_cast<Func**>(buffer); },
+    };
+
+    void move_from(small_function& other) noexcept
+    {
+        if (other.m_operations) {
+            other.m_operations->move(other.m_buffer, m_buffer);
+            m_operations = std::exchange(other.m_operations, nullptr);
+        }
+    }
+
+    alignas(std::max_align_t) mutable std::byte m_buffer[BufferSize < sizeof(void*) ? sizeof(void*) : BufferSize]{};
+    const operations* m_operations{};
+};
+
+/**
+ * \brief Intrusive list of callbacks.
+ *
+ * Subscribing returns a callback_list::subscription object, which contains the callback and the list links. This
+ * means that subscribing does not allocate (as long as the callback fits in a small_function), and that
+ * unsubscribing (by destroying or resetting the subscription) takes constant time.
+ *
+ * Callbacks may unsubscribe (by resetting or destroying the subscription) themselves or other callbacks while being
+ * notified. The function object of a callback is kept alive until the callback returns, so its captures remain
+ * valid even if it unsubscribes itself. Callbacks subscribed while a notification is in progress are not called until
+ * the next notification, and a callback is not called again by a notification started from within that callback.
+ *
+ * \note This class is not thread-safe.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * cui::callback_list<uint32_t> m_font_changed_callbacks;
+ *
+ * // Subscribing
+ * m_subscription = m_font_changed_callbacks.subscribe([this](uint32_t mask) { on_font_changed(mask); });
+ *
+ * // Notifying
+ * m_font_changed_callbacks.notify(changed_items_mask);
+ * \endcode
+ */
+template <class... Args>
+class callback_list {
+public:
+    using function_t = small_function<void(Args...)>;
+
+    /**
+     * \brief Subscription to a callback_list.
+     *
+     * The callback is unsubscribed when this object is destroyed or reset.
+     */
+    class subscription {
+    public:
+        subscription() = default;
+
+        subscription(subscription&& other) noexcept { move_from(other); }
+
+        subscription& operator=(subscription&& other) noexcept
+        {
+            if (this != &other) {
+                reset();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        subscription(const subscription&) = delete;
+        subscription& operator=(const subscription&) = delete;
+
+        ~subscription() { reset(); }
+
+        /** Unsubscribe the callback. */
+        void reset() noexcept
+        {
+            if (m_list)
+                m_list->unlink(*this);
+
+            m_function.reset();
+        }
+
+        [[nodiscard]] bool is_subscribed() const noexcept { return m_list != nullptr; }
+
+    private:
+        friend class callback_list;
+
+        subscription(callback_list& list, function_t function) : m_function(std::move(function))
+        {
+            list.link(*this);
+        }
+
+        void move_from(subscription& other) noexcept
+        {
+            m_function = std::move(other.m_function);
+
+            if (!other.m_list)
+                return;
+
+            m_list = std::exchange(other.m_list, nullptr);
+            m_previous = std::exchange(other.m_previous, nullptr);
+            m_next = std::exchange(other.m_next, nullptr);
+
+            (m_previous ? m_previous->m_next : m_list->m_head) = this;
+            (m_next ? m_next->m_previous : m_list->m_tail) = this;
+
+            for (auto notification = m_list->m_notifications; notification; notification = notification->outer) {
+                if (notification->next == &other)
+                    notification->next = this;
+
+                if (notification->last == &other)
+                    notification->last = this;
+
+                if (notification->current == &other)
+                    notification->current = this;
+            }
+        }
+
+        callback_list* m_list{};
+        subscription* m_previous{};
+        subscription* m_next{};
+        function_t m_function;
+    };
+
+    callback_list() = default;
+    callback_list(const callback_list&) = delete;
+    callback_list& operator=(const callback_list&) = delete;
+
+    ~callback_list()
+    {
+        while (m_head)
+            unlink(*m_head);
+    }
+
+    /**
+     * Subscribe a callback.
+     *
+     * \param function  function to call when notify() is called
+     * \return          subscription; the callback is unsubscribed when it is destroyed or reset
+     */
+    [[nodiscard]] subscription subscribe(function_t function) { return subscription(*this, std::move(function)); }
+
+    /** Call all subscribed callbacks. */
+    void notify(Args... args)
+    {
+        if (!m_head)
+            return;
+
+        notification current_notification(*this);
+
+        while (auto item = current_notification.next) {
+            current_notification.next = item == current_notification.last ? nullptr : item->m_next;
+
+            if (item == current_notification.last)
+                current_notification.last = nullptr;
+
+            // The function of a callback running in an outer notification has been borrowed by that notification
+            if (!item->m_function)
+                continue;
+
+            current_notification.begin_call(*item);
+            current_notification.current_function(args...);
+            current_notification.end_call();
+        }
+    }
+
+    [[nodiscard]] bool is_empty() const noexcept { return m_head == nullptr; }
+
+private:
+    struct notification {
+        explicit notification(callback_list& list)
+            : list(list)
+            , next(list.m_head)
+            , last(list.m_tail)
+            , outer(list.m_notifications)
+        {
+            list.m_notifications = this;
+        }
+
+        ~notification()
+        {
+            end_call();
+            list.m_notifications = outer;
+        }
+
+        notification(const notification&) = delete;
+        notification& operator=(const notification&) = delete;
+
+        /**
+         * Borrow the function of a subscription while it's being called, so that the subscription can be reset or
+         * destroyed by the callback without destroying the running function object.
+         */
+        void begin_call(subscription& item) noexcept
+        {
+            current = &item;
+            current_function = std::move(item.m_function);
+        }
+
+        /** Return the function to its subscription, or destroy it if the subscription was unsubscribed. */
+        void end_call() noexcept
+        {
+            if (current)
+                std::exchange(current, nullptr)->m_function = std::move(current_function);
+            else
+                current_function.reset();
+        }
+
+        callback_list& list;
+        subscription* next{};
+        subscription* last{};
+        notification* outer{};
+        subscription* current{};
+        function_t current_function;
+    };
+
+    void link(subscription& item) noexcept
+    {
+        item.m_list = this;
+        item.m_previous = m_tail;
+        item.m_next = nullptr;
+
+        (m_tail ? m_tail->m_next : m_head) = &item;
+        m_tail = &item;
+    }
+
+    void unlink(subscription& item) noexcept
+    {
+        for (auto current_notification = m_notifications; current_notification;
+             current_notification = current_notification->outer) {
+            if (current_notification->last == &item)
+                current_notification->last = current_notification->next == &item ? nullptr : item.m_previous;
+
+            if (current_notification->next == &item)
+                current_notification->next = current_notification->last ? item.m_next : nullptr;
+
+            if (current_notification->current == &item)
+                current_notification->current = nullptr;
+        }
+
+        (item.m_previous ? item.m_previous->m_next : m_head) = item.m_next;
+        (item.m_next ? item.m_next->m_previous : m_tail) = item.m_previous;
+
+        item.m_list = nullptr;
+        item.m_previous = nullptr;
+        item.m_next = nullptr;
+    }
+
+    subscription* m_head{};
+    subscription* m_tail{};
+    notification* m_notifications{};
+};
+
+} // namespace cui
@@ -0,0 +1,85 @@
+#include "ui_extension.h"
+
+namespace cui::colours {
+
+snapshot::snapshot(const GUID& client_id, uint64_t version) : m_client_id(client_id), m_version(version)
+{
+    const helper helper(client_id);
+
+    for (size_t index{}; index < colour_count; ++index)
+        m_colours[index] = helper.get_colour(static_cast<colour_identifier_t>(index));
+
+    for (size_t index{}; index < bool_count; ++index)
+        m_bools[index] = helper.get_bool(static_cast<bool_identifier_t>(index));
+
+    m_themed = helper.get_themed();
+}
+
+snapshot_cache& snapshot_cache::s_get()
+{
+    static snapshot_cache cache;
+    return cache;
+}
+
+snapshot_cache::~snapshot_cache()
+{
+    auto entry = m_head.load(std::memory_order_acquire);
+
+    while (entry) {
+        const auto next = entry->next;
+        delete entry;
+        entry = next;
+    }
+}
+
+snapshot_cache::entry& snapshot_cache::get_entry(const GUID& client_id)
+{
+    auto head = m_head.load(std::memory_order_acquire);
+
+    for (auto entry = head; entry; entry = entry->next) {
+        if (entry->client_id == client_id)
+            return *entry;
+    }
+
+    auto new_entry = std::make_unique<entry>(client_id);
+    refresh(*new_entry);
+
+    while (true) {
+        new_entry->next = head;
+
+        if (m_head.compare_exchange_weak(head, new_entry.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+            return *new_entry.release();
+
+        // Another thread added an entry. Check it isn't one for the same client.
+        for (auto entry = head; entry && entry != new_entry->next; entry = entry->next) {
+            if (entry->client_id == client_id)
+                return *entry;
+        }
+    }
+}
+
+void snapshot_cache::invalidate(const GUID& client_id) const
+{
+    for (auto entry = m_head.load(std::memory_order_acquire); entry; entry = entry->next) {
+        if (entry->client_id == client_id) {
+            refresh(*entry);
+            break;
+        }
+    }
+}
+
+void snapshot_cache::invalidate_all() const
+{
+    for (auto entry = m_head.load(std::memory_order_acquire); entry; entry = entry->next)
+        refresh(*entry);
+}
+
+void snapshot_cache::refresh(entry& entry) const
+{
+    // The snapshot is created and published while holding the lock, so that a snapshot of older colours can't
+    // replace one of newer colours. The previous snapshot is freed once it's no longer referenced.
+    std::scoped_lock lock(m_mutex);
+    entry.current.store(std::make_shared<const snapshot>(entry.client_id, ++m_version), std::memory_order_release);
+}
+
+} // namespace cui::colours
@@ -0,0 +1,137 @@
+#pragma once
+
+namespace cui::colours {
+
+/**
+ * \brief Immutable copy of all colours and boolean flags for a colour client.
+ *
+ * \see snapshot_helper
+ */
+class snapshot {
+public:
+    static constexpr size_t colour_count = colour_group_background + 1;
+    static constexpr size_t bool_count = bool_dark_mode_enabled + 1;
+
+    /** Create a snapshot of the current values for a client (null GUID implies global settings). */
+    snapshot(const GUID& client_id, uint64_t version);
+
+    [[nodiscard]] COLORREF get_colour(const colour_identifier_t& identifier) const { return m_colours[identifier]; }
+    [[nodiscard]] bool get_bool(const bool_identifier_t& identifier) const { return m_bools[identifier]; }
+    [[nodiscard]] bool get_themed() const { return m_themed; }
+    [[nodiscard]] bool is_dark_mode_active() const { return m_bools[bool_dark_mode_enabled]; }
+
+    /**
+     * Get the version of this snapshot. This increases every time any snapshot is refreshed.
+     *
+     * This can be used to determine whether anything derived from a snapshot needs to be recreated.
+     */
+    [[nodiscard]] uint64_t get_version() const { return m_version; }
+
+    [[nodiscard]] const GUID& get_client_id() const { return m_client_id; }
+
+private:
+    GUID m_client_id{};
+    uint64_t m_version{};
+    std::array<COLORREF, colour_count> m_colours{};
+    std::array<bool, bool_count> m_bools{};
+    bool m_themed{};
+};
+
+/**
+ * \brief Holds the current colour snapshot of each colour client used in this module.
+ *
+ * Snapshots are refreshed when Columns UI notifies common callbacks of a colour or boolean flag change.
+ *
+ * \note
+ * Columns UI may not notify common callbacks when only the colours of a specific client change. If you use a
+ * client-specific snapshot, call invalidate() with your client GUID from your client::on_colour_changed()
+ * and client::on_bool_changed() implementations.
+ *
+ * Snapshots are reference-counted, and a previous snapshot is freed once nothing holds a reference to it.
+ */
+class snapshot_cache final : public shared_cache_base {
+public:
+    struct entry {
+        explicit entry(const GUID& client_id) : client_id(client_id) {}
+
+        const GUID client_id;
+        std::atomic<std::shared_ptr<const snapshot>> current;
+        entry* next{};
+    };
+
+    static snapshot_cache& s_get();
+
+    /**
+     * Get the cache entry for a client. The entry remains valid until the module is unloaded.
+     *
+     * \param client_id  client GUID (null GUID implies global settings)
+     */
+    entry& get_entry(const GUID& client_id);
+
+    /** Get the current snapshot for a client (null GUID implies global settings). */
+    std::shared_ptr<const snapshot> get_snapshot(const GUID& client_id)
+    {
+        return get_entry(client_id).current.load(std::memory_order_acquire);
+    }
+
+    /** Refresh the snapshot of a client. */
+    void invalidate(const GUID& client_id) const;
+
+    /** Refresh the snapshots of all clients. */
+    void invalidate_all() const;
+
+private:
+    class colour_callback : public common_callback {
+    public:
+        void on_colour_changed(uint32_t changed_items_mask) const override { s_get().invalidate_all(); }
+        void on_bool_changed(uint32_t changed_items_mask) const override { s_get().invalidate_all(); }
+    };
+
+    snapshot_cache() { register_common_callback<manager>(std::make_shared<colour_callback>()); }
+    ~snapshot_cache() override;
+
+    void refresh(entry& entry) const;
+
+    std::atomic<entry*> m_head{};
+    mutable std::mutex m_mutex;
+    mutable uint64_t m_version{};
+};
+
+/**
+ * \brief Alternative to helper that reads colours from a cached snapshot.
+ *
+ * Constructing this is cheap once the client has been used, and reading the current snapshot is a single
+ * atomic load of a `std::shared_ptr`. To read several values from the same snapshot, call get() once and keep the
+ * returned pointer while reading them.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * const cui::colours::snapshot_helper colours(my_client_id);
+ * const auto snapshot = colours.get();
+ * const auto background_colour = snapshot->get_colour(cui::colours::colour_background);
+ * \endcode
+ */
+class snapshot_helper {
+public:
+    /** You can omit guid for the global colours */
+    explicit snapshot_helper(const GUID& client_id = GUID{}) : m_entry(&snapshot_cache::s_get().get_entry(client_id)) {}
+
+    /** Get the current snapshot. */
+    [[nodiscard]] std::shared_ptr<const snapshot> get() const
+    {
+        return m_entry->current.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] COLORREF get_colour(const colour_identifier_t& identifier) const
+    {
+        return get()->get_colour(identifier);
+    }
+    [[nodiscard]] bool get_bool(const bool_identifier_t& identifier) const { return get()->get_bool(identifier); }
+    [[nodiscard]] bool get_themed() const { return get()->get_themed(); }
+    [[nodiscard]] bool is_dark_mode_active() const { return get()->is_dark_mode_active(); }
+
+private:
+    snapshot_cache::entry* m_entry;
+};
+
+} // namespace cui::colours
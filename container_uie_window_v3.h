@@ -22,6 +22,8 @@ public:
     HWND create_or_transfer_window(
         HWND parent, const window_host_ptr& host, const ui_helpers::window_position_t& position) final
     {
+        tracing::scoped_trace trace(*this, tracing::operation_type::create_or_transfer_window);
+
         if (get_wnd()) {
             ShowWindow(get_wnd(), SW_HIDE);
             SetParent(get_wnd(), parent);
@@ -31,11 +33,11 @@ public:
             SetWindowPos(get_wnd(), nullptr, position.x, position.y, position.cx, position.cy, SWP_NOZORDER);
         } else {
             m_host = host;
-            m_window = std::make_unique<container_window_v3>(
-                get_window_config(), [this, _ = typename Base::ptr{this}](auto&&... args) {
-                    return on_message(std::forward<decltype(args)>(args)...);
-                });
-            m_window->create(parent, position.x, position.y, position.cx, position.cy);
+            m_self = this;
+            m_window = std::make_unique<container_window_v3>(get_window_config(), &s_on_message, this);
+
+            if (const auto wnd = m_window->create(parent, position.x, position.y, position.cx, position.cy))
+                on_window_created(wnd);
         }
 
         return get_wnd();
@@ -43,7 +45,14 @@ public:
 
     void destroy_window() final
     {
+        // Keep this instance alive until the end of this function
+        auto self = std::move(m_self);
+        tracing::scoped_trace trace(*this, tracing::operation_type::destroy_window);
+
         if (m_window) {
+            if (const auto wnd = m_window->get_wnd())
+                on_window_destroying(wnd);
+
             m_window->destroy();
             m_window.reset();
         }
@@ -51,11 +60,157 @@ public:
         m_host.release();
     }
 
+protected:
+    /**
+     * Called by create_or_transfer_window() after the window has been created.
+     */
+    virtual void on_window_created(HWND wnd) {}
+
+    /**
+     * Called by destroy_window() before the window is destroyed.
+     */
+    virtual void on_window_destroying(HWND wnd) {}
+
 private:
+    static LRESULT s_on_message(void* context, HWND wnd, UINT msg, WPARAM wp, LPARAM lp)
+    {
+        return static_cast<container_uie_window_v3_t*>(context)->on_message(wnd, msg, wp, lp);
+    }
+
     std::unique_ptr<container_window_v3> m_window;
     window_host_ptr m_host;
+    typename Base::ptr m_self;
 };
 
 using container_uie_window_v3 = container_uie_window_v3_t<>;
 
+/**
+ * A base implementation of uie::window_v2 using uie::container_window_v3
+ *
+ * Tracks whether the host has suspended the window, and provides helpers to defer repaints and pause timers while
+ * the window is suspended. The suspended state is kept if the window is destroyed and created again.
+ */
+template <class Base = window_v2>
+class suspendable_container_uie_window_v3_t : public container_uie_window_v3_t<Base> {
+public:
+    void on_suspend() final
+    {
+        if (m_is_suspended)
+            return;
+
+        m_is_suspended = true;
+
+        if (const auto wnd = this->get_wnd()) {
+            for (auto&& [id, elapse] : m_timers)
+                KillTimer(wnd, id);
+        }
+
+        on_suspended_change(true);
+    }
+
+    void on_resume() final
+    {
+        if (!m_is_suspended)
+            return;
+
+        m_is_suspended = false;
+
+        if (const auto wnd = this->get_wnd()) {
+            for (auto&& [id, elapse] : m_timers)
+                SetTimer(wnd, id, elapse, nullptr);
+
+            if (m_is_invalidation_pending)
+                RedrawWindow(wnd, nullptr, nullptr, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+        }
+
+        m_is_invalidation_pending = false;
+        on_suspended_change(false);
+    }
+
+    /**
+     * Get whether the host has suspended the window.
+     */
+    [[nodiscard]] bool is_suspended() const { return m_is_suspended; }
+
+    /**
+     * Invalidate the window and its children, or defer doing so until the window is resumed if it's suspended.
+     */
+    void invalidate()
+    {
+        if (m_is_suspended) {
+            m_is_invalidation_pending = true;
+            return;
+        }
+
+        if (const auto wnd = this->get_wnd())
+            RedrawWindow(wnd, nullptr, nullptr, RDW_ERASE | RDW_INVALIDATE | RDW_ALLCHILDREN);
+    }
+
+    /**
+     * Set a timer that is stopped while the window is suspended.
+     *
+     * The timer sends `WM_TIMER` messages to the window, as with `SetTimer()`. If the window hasn't been created yet,
+     * the timer is started when it's created (or when it's resumed, if the host suspended it before then). Timers
+     * are removed when the window is destroyed.
+     */
+    void set_timer(UINT_PTR id, UINT elapse)
+    {
+        std::erase_if(m_timers, [id](auto&& timer) { return timer.first == id; });
+        m_timers.emplace_back(id, elapse);
+
+        if (!m_is_suspended && this->get_wnd())
+            SetTimer(this->get_wnd(), id, elapse, nullptr);
+    }
+
+    /**
+     * Stop a timer set using set_timer().
+     */
+    void kill_timer(UINT_PTR id)
+    {
+        std::erase_if(m_timers, [id](auto&& timer) { return timer.first == id; });
+
+        if (this->get_wnd())
+            KillTimer(this->get_wnd(), id);
+    }
+
+protected:
+    /**
+     * Called after the window is suspended or resumed.
+     *
+     * Override this to stop or restart other work (such as callbacks) that is only needed while the window is
+     * visible.
+     */
+    virtual void on_suspended_change(bool is_suspended) {}
+
+    void on_window_created(HWND wnd) final
+    {
+        // A new window is painted in full anyway. The suspended state is kept, as the host may have suspended the
+        // window before it was created or while it was being recreated.
+        m_is_invalidation_pending = false;
+
+        if (m_is_suspended)
+            return;
+
+        // Start timers set before the window was created
+        for (auto&& [id, elapse] : m_timers)
+            SetTimer(wnd, id, elapse, nullptr);
+    }
+
+    void on_window_destroying(HWND wnd) final
+    {
+        for (auto&& [id, elapse] : m_timers)
+            KillTimer(wnd, id);
+
+        m_timers.clear();
+        m_is_invalidation_pending = false;
+    }
+
+private:
+    std::vector<std::pair<UINT_PTR, UINT>> m_timers;
+    bool m_is_suspended{};
+    bool m_is_invalidation_pending{};
+};
+
+using suspendable_container_uie_window_v3 = suspendable_container_uie_window_v3_t<>;
+
 } // namespace uie
@@ -2,11 +2,30 @@
 
 namespace uie {
 
+namespace {
+
+/** Get the position of a window, in the same coordinates as WINDOWPOS::x and WINDOWPOS::y. */
+POINT get_window_position(HWND wnd)
+{
+    RECT window_rect{};
+    GetWindowRect(wnd, &window_rect);
+
+    POINT position{window_rect.left, window_rect.top};
+
+    if (GetWindowLongPtr(wnd, GWL_STYLE) & WS_CHILD)
+        MapWindowPoints(HWND_DESKTOP, GetParent(wnd), &position, 1);
+
+    return position;
+}
+
+} // namespace
+
 HWND container_window_v3::create(HWND wnd_parent, int x, int y, int cx, int cy)
 {
-    if (!s_registered_classes.contains(m_config.class_name)) {
-        register_class();
-    }
+    m_class_entry = &s_class_registry.find_or_add(m_config.class_name);
+
+    if (!m_has_class_reference && !acquire_class())
+        return nullptr;
 
     m_wnd = CreateWindowEx(m_config.extended_window_styles, m_config.class_name, m_config.window_title,
         m_config.window_styles, x, y, cx, cy, wnd_parent, nullptr, core_api::get_my_instance(), this);
@@ -17,6 +36,8 @@ HWND container_window_v3::create(HWND wnd_parent, int x, int y, int cx, int cy)
 
         console::formatter formatter;
         formatter << "CreateWindowEx failed: " << message;
+
+        deregister_class();
     }
 
     return m_wnd;
@@ -32,9 +53,7 @@ void container_window_v3::destroy() const
     if (m_wnd)
         DestroyWindow(m_wnd);
 
-    if (s_window_count[m_config.class_name] == 0) {
-        deregister_class();
-    }
+    deregister_class();
 }
 
 LRESULT container_window_v3::s_on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp) noexcept
@@ -57,15 +76,13 @@ LRESULT container_window_v3::s_on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM
 LRESULT container_window_v3::on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp)
 {
     switch (msg) {
-    case WM_NCCREATE: {
+    case WM_NCCREATE:
         m_wnd = wnd;
-        const auto [item, _] = s_window_count.try_emplace(m_config.class_name, 0);
-        ++item->second;
         break;
-    }
     case WM_NCDESTROY:
-        --s_window_count[m_config.class_name];
         m_wnd = nullptr;
+        m_last_position.reset();
+        m_last_client_size.reset();
         break;
     case WM_SETTINGCHANGE:
     case WM_SYSCOLORCHANGE:
@@ -88,21 +105,116 @@ LRESULT container_window_v3::on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp
             const auto lpwp = reinterpret_cast<LPWINDOWPOS>(lp);
 
             if (!(lpwp->flags & SWP_NOSIZE) || !(lpwp->flags & SWP_NOMOVE) || (lpwp->flags & SWP_FRAMECHANGED)) {
-                auto flags = RDW_ERASE | RDW_INVALIDATE;
-
-                if (m_config.invalidate_children_on_move_or_resize)
-                    flags |= RDW_ALLCHILDREN;
-
-                RedrawWindow(wnd, nullptr, nullptr, flags);
+                invalidate_after_move_or_resize(wnd, *lpwp);
             }
         }
         break;
     }
 
+    if (m_dispatcher)
+        return m_dispatcher(m_dispatcher_context, wnd, msg, wp, lp);
+
     return m_on_message ? m_on_message(wnd, msg, wp, lp) : DefWindowProc(wnd, msg, wp, lp);
 }
 
-void container_window_v3::register_class() const
+void container_window_v3::invalidate_after_move_or_resize(HWND wnd, const WINDOWPOS& window_pos)
+{
+    auto flags = RDW_ERASE | RDW_INVALIDATE;
+
+    if (m_config.invalidate_children_on_move_or_resize)
+        flags |= RDW_ALLCHILDREN;
+
+    RECT client_rect{};
+    GetClientRect(wnd, &client_rect);
+
+    const auto position = POINT{window_pos.x, window_pos.y};
+    const auto client_size = SIZE{client_rect.right, client_rect.bottom};
+
+    const auto previous_position = m_last_position;
+    const auto previous_client_size = m_last_client_size;
+
+    if (!(window_pos.flags & SWP_NOMOVE))
+        m_last_position = position;
+    else if (!m_last_position)
+        // The first message may only be for a resize, so take the position from the window itself
+        m_last_position = get_window_position(wnd);
+
+    m_last_client_size = client_size;
+
+    const auto moved = !(window_pos.flags & SWP_NOMOVE) && previous_position
+        && (previous_position->x != position.x || previous_position->y != position.y);
+
+    if (!m_config.invalidate_exposed_areas_only || !previous_client_size || moved
+        || (window_pos.flags & SWP_FRAMECHANGED)) {
+        invalidate_rect(wnd, client_rect, flags);
+        return;
+    }
+
+    // The top-left corner hasn't moved, so only areas outside the previous client area have been exposed.
+    if (client_size.cx > previous_client_size->cx)
+        invalidate_rect(wnd, {previous_client_size->cx, 0, client_size.cx, client_size.cy}, flags);
+
+    if (client_size.cy > previous_client_size->cy) {
+        const auto right = std::min(previous_client_size->cx, client_size.cx);
+        invalidate_rect(wnd, {0, previous_client_size->cy, right, client_size.cy}, flags);
+    }
+}
+
+void container_window_v3::invalidate_rect(HWND wnd, const RECT& rect, unsigned flags)
+{
+    if (IsRectEmpty(&rect))
+        return;
+
+    RedrawWindow(wnd, &rect, nullptr, flags);
+
+    ++m_invalidation_stats.invalidation_count;
+    m_invalidation_stats.invalidated_area
+        += static_cast<uint64_t>(rect.right - rect.left) * static_cast<uint64_t>(rect.bottom - rect.top);
+}
+
+bool container_window_v3::acquire_class() const
+{
+    auto& entry = get_class_entry();
+    auto reference_count = entry.reference_count.load(std::memory_order_acquire);
+
+    // If the class is already registered, just add a reference
+    while (reference_count > 0) {
+        if (entry.reference_count.compare_exchange_weak(
+                reference_count, reference_count + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            m_has_class_reference = true;
+            return true;
+        }
+    }
+
+    std::scoped_lock lock(entry.registration_mutex);
+
+    if (entry.reference_count.load(std::memory_order_acquire) == 0 && !register_class())
+        return false;
+
+    entry.reference_count.fetch_add(1, std::memory_order_acq_rel);
+    m_has_class_reference = true;
+    return true;
+}
+
+void container_window_v3::release_class() const
+{
+    auto& entry = get_class_entry();
+    auto reference_count = entry.reference_count.load(std::memory_order_acquire);
+
+    // If this isn't the last reference, just remove it
+    while (reference_count > 1) {
+        if (entry.reference_count.compare_exchange_weak(
+                reference_count, reference_count - 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            return;
+    }
+
+    std::scoped_lock lock(entry.registration_mutex);
+
+    if (entry.reference_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        unregister_class();
+}
+
+bool container_window_v3::register_class() const
 {
     auto wc = WNDCLASS{};
 
@@ -114,24 +226,22 @@ void container_window_v3::register_class() const
     wc.style = m_config.class_styles;
     wc.cbWndExtra = m_config.class_extra_wnd_bytes;
 
-    if (!RegisterClass(&wc)) {
+    // The class may still be registered if a previous attempt to deregister it failed
+    if (!RegisterClass(&wc) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
         pfc::string8 message;
         uFormatMessage(GetLastError(), message);
 
         console::formatter formatter;
         formatter << "RegisterClass failed: " << message;
+        return false;
     }
 
-    s_registered_classes.insert(m_config.class_name);
+    return true;
 }
 
-void container_window_v3::deregister_class() const
+void container_window_v3::unregister_class() const
 {
-    const auto deregistered = UnregisterClass(m_config.class_name, core_api::get_my_instance());
-
-    if (deregistered) {
-        s_registered_classes.erase(m_config.class_name);
-    } else {
+    if (!UnregisterClass(m_config.class_name, core_api::get_my_instance())) {
         pfc::string8 message;
         uFormatMessage(GetLastError(), message);
 
@@ -140,4 +250,61 @@ void container_window_v3::deregister_class() const
     }
 }
 
+void container_window_v3::deregister_class() const
+{
+    if (!m_has_class_reference)
+        return;
+
+    m_has_class_reference = false;
+    release_class();
+}
+
+container_window_v3::class_entry& container_window_v3::get_class_entry() const
+{
+    return m_class_entry ? *m_class_entry : s_class_registry.find_or_add(m_config.class_name);
+}
+
+container_window_v3::class_registry::~class_registry()
+{
+    auto entry = m_head.exchange(nullptr);
+
+    while (entry) {
+        const auto next = entry->next;
+        delete entry;
+        entry = next;
+    }
+}
+
+container_window_v3::class_entry& container_window_v3::class_registry::find_or_add(const wchar_t* class_name)
+{
+    auto head = m_head.load(std::memory_order_acquire);
+
+    if (const auto entry = s_find(head, nullptr, class_name))
+        return *entry;
+
+    auto new_entry = std::make_unique<class_entry>(class_name);
+    new_entry->next = head;
+
+    while (!m_head.compare_exchange_weak(head, new_entry.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        // Check entries added by other threads since the list was last searched
+        if (const auto entry = s_find(head, new_entry->next, class_name))
+            return *entry;
+
+        new_entry->next = head;
+    }
+
+    return *new_entry.release();
+}
+
+container_window_v3::class_entry* container_window_v3::class_registry::s_find(
+    class_entry* first, const class_entry* last, const wchar_t* class_name)
+{
+    for (auto entry = first; entry != last; entry = entry->next) {
+        if (entry->class_name == std::wstring_view(class_name))
+            return entry;
+    }
+
+    return nullptr;
+}
+
 } // namespace uie
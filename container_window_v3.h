@@ -23,6 +23,20 @@ struct container_window_v3_config {
     bool use_transparent_background{true};
     bool invalidate_children_on_move_or_resize{};
 
+    /**
+     * Whether to only invalidate newly exposed areas when the window is resized, instead of the whole window.
+     *
+     * Only applies if use_transparent_background or invalidate_children_on_move_or_resize is true.
+     *
+     * The whole window is still invalidated if it's moved relative to its parent, or if its frame changes.
+     *
+     * If what you paint depends on the size of the window, you must invalidate it yourself (for example, by using the
+     * CS_HREDRAW and CS_VREDRAW class styles).
+     *
+     * \see container_window_v3::get_invalidation_stats()
+     */
+    bool invalidate_exposed_areas_only{};
+
     /**
      * Whether to forward WM_SETTINGCHANGE messages to direct child windows.
      *
@@ -47,6 +61,23 @@ struct container_window_v3_config {
     }
 };
 
+/**
+ * \brief Statistics about invalidations performed by a container_window_v3 when it's moved or resized.
+ */
+struct container_window_v3_invalidation_stats {
+    /** Number of times the window was invalidated due to a move or resize. */
+    uint64_t invalidation_count{};
+    /** Total area, in pixels, invalidated due to moves or resizes. */
+    uint64_t invalidated_area{};
+};
+
+/**
+ * \brief Function pointer type used by container_window_v3 to dispatch messages without a `std::function`.
+ *
+ * \param context  the context pointer passed to the container_window_v3 constructor
+ */
+using message_dispatcher_t = LRESULT (*)(void* context, HWND wnd, UINT msg, WPARAM wp, LPARAM lp);
+
 /**
  * \brief Implements a window that serves either as an empty container for other windows, or as window for a custom
  * control.
@@ -60,6 +91,20 @@ public:
     {
     }
 
+    /**
+     * Construct using a message dispatcher function pointer instead of a `std::function`.
+     *
+     * \param config      window and window class configuration
+     * \param dispatcher  function called for each message, for example message_map::s_dispatch
+     * \param context     pointer passed to the dispatcher function
+     */
+    container_window_v3(container_window_v3_config config, message_dispatcher_t dispatcher, void* context)
+        : m_config{config}
+        , m_dispatcher{dispatcher}
+        , m_dispatcher_context{context}
+    {
+    }
+
     container_window_v3(const container_window_v3& p_source) = delete;
     container_window_v3& operator=(const container_window_v3& p_source) = delete;
 
@@ -69,7 +114,8 @@ public:
     /**
      * Destroy the window.
      *
-     * If this is the last instance of this window class, the window class will also be deregistered.
+     * If no other instances with the same window class name have a window, the window class will also be
+     * deregistered.
      */
     void destroy() const;
 
@@ -78,23 +124,86 @@ public:
     /**
      * Deregister the window class.
      *
-     * If not using #destroy() to destryoy the window, call this to deregister the window class when
-     * all windows belonging to the class have ben destroyed.
+     * If not using #destroy() to destroy the window, call this after the window has been destroyed. The window
+     * class is only deregistered once no other instances with the same window class name have a window.
      */
     void deregister_class() const;
 
+    /**
+     * Get statistics about invalidations performed when the window was moved or resized.
+     *
+     * \see container_window_v3_config::invalidate_exposed_areas_only
+     */
+    [[nodiscard]] const container_window_v3_invalidation_stats& get_invalidation_stats() const
+    {
+        return m_invalidation_stats;
+    }
+
 private:
     static LRESULT WINAPI s_on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp) noexcept;
 
     LRESULT on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp);
-    void register_class() const;
+    bool acquire_class() const;
+    void release_class() const;
+    bool register_class() const;
+    void unregister_class() const;
+    void invalidate_after_move_or_resize(HWND wnd, const WINDOWPOS& window_pos);
+    void invalidate_rect(HWND wnd, const RECT& rect, unsigned flags);
+
+    /**
+     * Reference count for a window class name.
+     *
+     * Each instance that creates a window holds a reference until its window is destroyed. The window class is
+     * registered when the count goes from zero to one, and deregistered when it goes from one to zero. Those two
+     * transitions are serialised using registration_mutex, so that a class can't be deregistered while another
+     * thread is creating a window using it. Other changes to the count only involve atomic operations.
+     *
+     * Entries are created the first time a class name is used, and are never removed until the class registry
+     * is destroyed.
+     */
+    struct class_entry {
+        explicit class_entry(const wchar_t* class_name) : class_name(class_name) {}
+
+        const std::wstring class_name;
+        std::atomic<size_t> reference_count{};
+        std::mutex registration_mutex;
+        class_entry* next{};
+    };
+
+    /**
+     * Insert-only, lock-free list of window class entries.
+     *
+     * Entries are keyed by the contents of the class name, so the class name doesn't need to be a static string.
+     */
+    class class_registry {
+    public:
+        class_registry() = default;
+        class_registry(const class_registry&) = delete;
+        class_registry& operator=(const class_registry&) = delete;
+        ~class_registry();
+
+        class_entry& find_or_add(const wchar_t* class_name);
+
+    private:
+        static class_entry* s_find(class_entry* first, const class_entry* last, const wchar_t* class_name);
+
+        std::atomic<class_entry*> m_head{};
+    };
+
+    class_entry& get_class_entry() const;
 
-    inline static std::unordered_map<std::wstring, size_t> s_window_count;
-    inline static std::unordered_set<std::wstring> s_registered_classes;
+    inline static class_registry s_class_registry;
 
     HWND m_wnd{};
+    class_entry* m_class_entry{};
+    mutable bool m_has_class_reference{};
+    std::optional<POINT> m_last_position;
+    std::optional<SIZE> m_last_client_size;
+    container_window_v3_invalidation_stats m_invalidation_stats;
     container_window_v3_config m_config;
     std::function<LRESULT(HWND, UINT, WPARAM, LPARAM)> m_on_message;
+    message_dispatcher_t m_dispatcher{};
+    void* m_dispatcher_context{};
 };
 
 } // namespace uie
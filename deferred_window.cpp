@@ -0,0 +1,110 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+deferred_window::deferred_window(const splitter_item_t& item)
+    : m_id(item.get_panel_guid())
+    , m_config(item.get_panel_config_to_array())
+    , m_window(item.get_window_ptr())
+{
+}
+
+HWND deferred_window::get_wnd() const
+{
+    if (is_window_created())
+        return m_window->get_wnd();
+
+    return m_placeholder ? m_placeholder->get_wnd() : nullptr;
+}
+
+const window_ptr& deferred_window::instantiate()
+{
+    if (m_window.is_valid() || !window::create_by_guid(m_id, m_window))
+        return m_window;
+
+    try {
+        tracing::scoped_trace trace(*m_window.get_ptr(), tracing::operation_type::set_config);
+        m_window->set_config_from_ptr(m_config.get_ptr(), m_config.get_size(), fb2k::noAbort);
+    } catch (const pfc::exception& ex) {
+        console::formatter formatter;
+        formatter << "Failed to set panel configuration: " << ex.what();
+    }
+
+    return m_window;
+}
+
+HWND deferred_window::create_placeholder(HWND wnd_parent, const ui_helpers::window_position_t& position)
+{
+    if (is_window_created())
+        return m_window->get_wnd();
+
+    if (!m_placeholder) {
+        m_placeholder
+            = std::make_unique<container_window_v3>(container_window_v3_config(L"uie_deferred_window_placeholder"));
+        m_placeholder->create(wnd_parent, position.x, position.y, position.cx, position.cy);
+    }
+
+    return m_placeholder->get_wnd();
+}
+
+HWND deferred_window::create_window(
+    HWND wnd_parent, const window_host_ptr& host, const ui_helpers::window_position_t& position)
+{
+    if (is_window_created())
+        return m_window->get_wnd();
+
+    if (!instantiate().is_valid() || !m_window->is_available(host))
+        return nullptr;
+
+    const auto wnd = m_window->create_or_transfer_window(wnd_parent, host, position);
+    m_owns_window = wnd != nullptr;
+
+    // If the panel failed to create its window, the placeholder is kept so that the host still has a window
+    if (!wnd)
+        return nullptr;
+
+    if (m_placeholder && m_placeholder->get_wnd()) {
+        SetWindowPos(wnd, m_placeholder->get_wnd(), 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+    }
+
+    if (m_placeholder) {
+        m_placeholder->destroy();
+        m_placeholder.reset();
+    }
+
+    return wnd;
+}
+
+void deferred_window::destroy_window()
+{
+    if (m_owns_window && is_window_created()) {
+        try {
+            tracing::scoped_trace trace(*m_window.get_ptr(), tracing::operation_type::get_config);
+            m_config = m_window->get_config_as_array(fb2k::noAbort);
+        } catch (const pfc::exception& ex) {
+            console::formatter formatter;
+            formatter << "Failed to get panel configuration: " << ex.what();
+        }
+
+        m_window->destroy_window();
+    }
+
+    m_owns_window = false;
+
+    if (m_placeholder) {
+        m_placeholder->destroy();
+        m_placeholder.reset();
+    }
+}
+
+pfc::array_t<uint8_t> deferred_window::get_config_as_array() const
+{
+    if (m_window.is_valid()) {
+        tracing::scoped_trace trace(*m_window.get_ptr(), tracing::operation_type::get_config);
+        return m_window->get_config_as_array(fb2k::noAbort);
+    }
+
+    return m_config;
+}
+
+} // namespace uie
@@ -0,0 +1,114 @@
+#pragma once
+
+namespace uie {
+
+/**
+ * \brief Holds the ID and configuration of a hosted panel or toolbar, and only instantiates it and creates its window
+ * when it's first needed.
+ *
+ * This can be used by hosts to avoid instantiating panels in hidden splitter items or inactive tabs when restoring
+ * a layout.
+ *
+ * Until the real window is created, create_placeholder() can be used to create an empty, transparent window that
+ * the host can position in place of the panel.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * uie::deferred_window panel(*splitter_item);
+ *
+ * if (is_visible)
+ *     panel.create_window(wnd_parent, host, position);
+ * else
+ *     panel.create_placeholder(wnd_parent, position);
+ *
+ * // Later, when the panel first becomes visible:
+ * panel.create_window(wnd_parent, host, position);
+ * \endcode
+ */
+class deferred_window {
+public:
+    /**
+     * \param id      GUID of the panel
+     * \param config  configuration data of the panel
+     */
+    deferred_window(GUID id, pfc::array_t<uint8_t> config) : m_id(id), m_config(std::move(config)) {}
+
+    /**
+     * Copies the panel GUID and configuration data from a splitter item.
+     *
+     * If the splitter item already has a window instance, it will be used. However, if its window already exists,
+     * it remains owned by the splitter item's host, and won't be destroyed by destroy_window() or the destructor.
+     */
+    explicit deferred_window(const splitter_item_t& item);
+
+    deferred_window(const deferred_window&) = delete;
+    deferred_window& operator=(const deferred_window&) = delete;
+
+    ~deferred_window() { destroy_window(); }
+
+    [[nodiscard]] const GUID& get_panel_guid() const { return m_id; }
+
+    /**
+     * Get the window instance. Will be empty if the panel has not yet been instantiated.
+     */
+    [[nodiscard]] const window_ptr& get_window_ptr() const { return m_window; }
+
+    /**
+     * Get the window handle of the panel, or of the placeholder window if the panel window has not been created.
+     */
+    [[nodiscard]] HWND get_wnd() const;
+
+    /**
+     * Get whether the panel window has been created.
+     */
+    [[nodiscard]] bool is_window_created() const { return m_window.is_valid() && m_window->get_wnd(); }
+
+    /**
+     * Instantiate the panel and set its configuration, without creating its window.
+     *
+     * \return the window instance, or an empty pointer if the panel is not installed
+     */
+    const window_ptr& instantiate();
+
+    /**
+     * Create a placeholder window, if the panel window has not been created.
+     *
+     * \return handle of the placeholder window, or of the panel window if it has already been created
+     */
+    HWND create_placeholder(HWND wnd_parent, const ui_helpers::window_position_t& position);
+
+    /**
+     * Instantiate the panel and create its window, if that hasn't already been done.
+     *
+     * If a placeholder window exists, it's destroyed, and the panel window is inserted in its place in the
+     * z-order. If the panel window can't be created, the placeholder window is kept.
+     *
+     * \return handle of the panel window, or `nullptr` on failure
+     */
+    HWND create_window(HWND wnd_parent, const window_host_ptr& host, const ui_helpers::window_position_t& position);
+
+    /**
+     * Destroy the panel window or placeholder window.
+     *
+     * Only a panel window created by create_window() is destroyed. The panel configuration is retrieved from the
+     * panel before its window is destroyed.
+     */
+    void destroy_window();
+
+    /**
+     * Get the panel configuration data.
+     *
+     * If the panel has been instantiated, its configuration is retrieved from it. Otherwise, the stored
+     * configuration data is returned.
+     */
+    [[nodiscard]] pfc::array_t<uint8_t> get_config_as_array() const;
+
+private:
+    GUID m_id{};
+    pfc::array_t<uint8_t> m_config;
+    window_ptr m_window;
+    bool m_owns_window{};
+    std::unique_ptr<container_window_v3> m_placeholder;
+};
+
+} // namespace uie
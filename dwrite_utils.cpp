@@ -4,8 +4,82 @@
 
 namespace cui::dwrite_utils {
 
-HRESULT create_custom_rendering_params(IDWriteFactory* factory, HMONITOR monitor, DWRITE_RENDERING_MODE rendering_mode,
-    IDWriteRenderingParams** rendering_params)
+namespace {
+
+std::atomic<uint64_t> display_change_count{};
+
+/**
+ * Hidden top-level window that calls notify_display_changed() when display or font smoothing settings change.
+ *
+ * `WM_DISPLAYCHANGE` and `WM_SETTINGCHANGE` are only sent to top-level windows (and not to message-only windows).
+ */
+class display_change_window {
+public:
+    static display_change_window& s_get()
+    {
+        static display_change_window window;
+        return window;
+    }
+
+    void create()
+    {
+        if (m_is_shut_down || m_window.get_wnd() || !core_api::is_main_thread())
+            return;
+
+        m_window.create(nullptr);
+    }
+
+    void shutdown()
+    {
+        m_is_shut_down = true;
+        m_window.destroy();
+    }
+
+private:
+    static uie::container_window_v3_config s_make_config()
+    {
+        uie::container_window_v3_config config(L"{5C0D7E1B-4F55-4D3B-9A0A-6C1C4E2B8F31}", false);
+        config.window_styles = WS_POPUP;
+        config.extended_window_styles = WS_EX_TOOLWINDOW;
+        return config;
+    }
+
+    static LRESULT s_on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp)
+    {
+        switch (msg) {
+        case WM_DISPLAYCHANGE:
+            notify_display_changed();
+            break;
+        case WM_SETTINGCHANGE:
+            switch (wp) {
+            case SPI_SETFONTSMOOTHING:
+            case SPI_SETFONTSMOOTHINGCONTRAST:
+            case SPI_SETFONTSMOOTHINGORIENTATION:
+            case SPI_SETFONTSMOOTHINGTYPE:
+                notify_display_changed();
+                break;
+            }
+            break;
+        }
+
+        return DefWindowProc(wnd, msg, wp, lp);
+    }
+
+    uie::container_window_v3 m_window{s_make_config(), &s_on_message};
+    bool m_is_shut_down{};
+};
+
+class display_change_window_initquit : public initquit {
+public:
+    void on_quit() noexcept override { display_change_window::s_get().shutdown(); }
+};
+
+initquit_factory_t<display_change_window_initquit> g_display_change_window_initquit;
+
+} // namespace
+
+HRESULT create_custom_rendering_params(IDWriteFactory* factory, IDWriteFactory1* factory_1, IDWriteFactory2* factory_2,
+    HMONITOR monitor, DWRITE_RENDERING_MODE rendering_mode, IDWriteRenderingParams** rendering_params)
 {
     HRESULT hr{};
     pfc::com_ptr_t<IDWriteRenderingParams> monitor_rendering_params;
@@ -36,19 +110,13 @@ HRESULT create_custom_rendering_params(IDWriteFactory* factory, HMONITOR monitor
         ? std::make_optional(monitor_rendering_params_2->GetGridFitMode())
         : std::nullopt;
 
-    pfc::com_ptr_t<IDWriteFactory1> factory_1;
-    (void)factory->QueryInterface(__uuidof(IDWriteFactory1), factory_1.receive_void_ptr());
-
-    pfc::com_ptr_t<IDWriteFactory2> factory_2;
-    (void)factory->QueryInterface(__uuidof(IDWriteFactory2), factory_2.receive_void_ptr());
-
-    if (factory_2.is_valid() && grid_fit_mode && greyscale_enhanced_contrast) {
+    if (factory_2 && grid_fit_mode && greyscale_enhanced_contrast) {
         pfc::com_ptr_t<IDWriteRenderingParams2> custom_rendering_params_2;
         hr = factory_2->CreateCustomRenderingParams(gamma, enhanced_contrast, *greyscale_enhanced_contrast,
             cleartype_level, pixel_geometry, rendering_mode, *grid_fit_mode, custom_rendering_params_2.receive_ptr());
 
         *rendering_params = custom_rendering_params_2.detach();
-    } else if (factory_1.is_valid() && greyscale_enhanced_contrast) {
+    } else if (factory_1 && greyscale_enhanced_contrast) {
         pfc::com_ptr_t<IDWriteRenderingParams1> custom_rendering_params_1;
         hr = factory_1->CreateCustomRenderingParams(gamma, enhanced_contrast, *greyscale_enhanced_contrast,
             cleartype_level, pixel_geometry, rendering_mode, custom_rendering_params_1.receive_ptr());
@@ -62,6 +130,85 @@ HRESULT create_custom_rendering_params(IDWriteFactory* factory, HMONITOR monitor
     return hr;
 }
 
+HRESULT create_custom_rendering_params(IDWriteFactory* factory, HMONITOR monitor, DWRITE_RENDERING_MODE rendering_mode,
+    IDWriteRenderingParams** rendering_params)
+{
+    pfc::com_ptr_t<IDWriteFactory1> factory_1;
+    (void)factory->QueryInterface(__uuidof(IDWriteFactory1), factory_1.receive_void_ptr());
+
+    pfc::com_ptr_t<IDWriteFactory2> factory_2;
+    (void)factory->QueryInterface(__uuidof(IDWriteFactory2), factory_2.receive_void_ptr());
+
+    return create_custom_rendering_params(
+        factory, factory_1.get_ptr(), factory_2.get_ptr(), monitor, rendering_mode, rendering_params);
+}
+
+void notify_display_changed() noexcept
+{
+    display_change_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+HRESULT rendering_params_cache::get_rendering_params(IDWriteFactory* factory, HMONITOR monitor,
+    DWRITE_RENDERING_MODE rendering_mode, IDWriteRenderingParams** rendering_params) noexcept
+{
+    if (const auto current_display_change_count = display_change_count.load(std::memory_order_relaxed);
+        current_display_change_count != m_display_change_count) {
+        invalidate();
+        m_display_change_count = current_display_change_count;
+    }
+
+    try {
+        display_change_window::s_get().create();
+
+        if (m_factory.get_ptr() != factory)
+            set_factory(factory);
+
+        const auto iter = std::ranges::find_if(m_entries, [monitor, rendering_mode](const entry& item) {
+            return item.monitor == monitor && item.rendering_mode == rendering_mode;
+        });
+
+        if (iter != m_entries.end()) {
+            // Move to the front, so that the least recently used entry is evicted first
+            std::rotate(m_entries.begin(), iter, iter + 1);
+        } else {
+            pfc::com_ptr_t<IDWriteRenderingParams> new_rendering_params;
+            const auto hr = create_custom_rendering_params(m_factory.get_ptr(), m_factory_1.get_ptr(),
+                m_factory_2.get_ptr(), monitor, rendering_mode, new_rendering_params.receive_ptr());
+
+            if (FAILED(hr))
+                return hr;
+
+            if (m_entries.size() >= max_monitors)
+                m_entries.pop_back();
+
+            m_entries.insert(m_entries.begin(), entry{monitor, rendering_mode, std::move(new_rendering_params)});
+        }
+    } catch (const std::bad_alloc&) {
+        return E_OUTOFMEMORY;
+    }
+
+    *rendering_params = m_entries.front().rendering_params.get_ptr();
+    (*rendering_params)->AddRef();
+    return S_OK;
+}
+
+void rendering_params_cache::invalidate() noexcept
+{
+    m_entries.clear();
+    m_factory.release();
+    m_factory_1.release();
+    m_factory_2.release();
+}
+
+void rendering_params_cache::set_factory(IDWriteFactory* factory)
+{
+    invalidate();
+
+    m_factory = factory;
+    (void)factory->QueryInterface(__uuidof(IDWriteFactory1), m_factory_1.receive_void_ptr());
+    (void)factory->QueryInterface(__uuidof(IDWriteFactory2), m_factory_2.receive_void_ptr());
+}
+
 HMONITOR get_monitor_for_window(HWND wnd)
 {
     const auto root_window = GetAncestor(wnd, GA_ROOT);
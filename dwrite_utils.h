@@ -22,4 +22,73 @@ HMONITOR get_monitor_for_window(HWND wnd);
 HRESULT create_custom_rendering_params(IDWriteFactory* factory, HMONITOR monitor, DWRITE_RENDERING_MODE rendering_mode,
     IDWriteRenderingParams** rendering_params);
 
+/**
+ * Create DirectWrite rendering params for a monitor and specific rendering options, using factory interfaces that
+ * have already been queried for.
+ *
+ * @param factory Pre-created DirectWrite factory
+ * @param factory_1 The IDWriteFactory1 interface of factory, or `nullptr` if it's not supported
+ * @param factory_2 The IDWriteFactory2 interface of factory, or `nullptr` if it's not supported
+ * @param monitor Monitor handle returned by `get_monitor_for_window()`
+ * @param rendering_mode Rendering mode returned by `cui::fonts::rendering_options::rendering_mode()`
+ * @param rendering_params Receives a pointer to the created IDWriteRenderingParams on success
+ * @return HRESULT indicating success or failure code
+ */
+HRESULT create_custom_rendering_params(IDWriteFactory* factory, IDWriteFactory1* factory_1, IDWriteFactory2* factory_2,
+    HMONITOR monitor, DWRITE_RENDERING_MODE rendering_mode, IDWriteRenderingParams** rendering_params);
+
+/**
+ * Notify all rendering_params_cache instances in this module that display settings have changed.
+ *
+ * This is called automatically when `WM_DISPLAYCHANGE` is received, or when `WM_SETTINGCHANGE` is received for a
+ * font smoothing setting. (A hidden top-level window is created for this the first time a rendering_params_cache is
+ * used on the main thread, as child windows don't receive those messages.)
+ */
+void notify_display_changed() noexcept;
+
+/**
+ * Caches DirectWrite rendering params for a small number of monitors.
+ *
+ * This avoids recreating rendering params when a window spans or moves between monitors. The factory interfaces
+ * needed to create custom rendering params are queried for once.
+ *
+ * Cached rendering params are discarded when notify_display_changed() is called.
+ *
+ * \note This class is not thread-safe.
+ */
+class rendering_params_cache {
+public:
+    static constexpr size_t max_monitors = 4;
+
+    /**
+     * Get rendering params for a monitor and rendering mode.
+     *
+     * @param factory Pre-created DirectWrite factory
+     * @param monitor Monitor handle returned by `get_monitor_for_window()`
+     * @param rendering_mode Rendering mode returned by `cui::fonts::rendering_options::rendering_mode()`
+     * @param rendering_params Receives a pointer to the IDWriteRenderingParams on success
+     * @return HRESULT indicating success or failure code
+     */
+    HRESULT get_rendering_params(IDWriteFactory* factory, HMONITOR monitor, DWRITE_RENDERING_MODE rendering_mode,
+        IDWriteRenderingParams** rendering_params) noexcept;
+
+    /** Discard all cached rendering params and factory interfaces. */
+    void invalidate() noexcept;
+
+private:
+    struct entry {
+        HMONITOR monitor{};
+        DWRITE_RENDERING_MODE rendering_mode{};
+        pfc::com_ptr_t<IDWriteRenderingParams> rendering_params;
+    };
+
+    void set_factory(IDWriteFactory* factory);
+
+    pfc::com_ptr_t<IDWriteFactory> m_factory;
+    pfc::com_ptr_t<IDWriteFactory1> m_factory_1;
+    pfc::com_ptr_t<IDWriteFactory2> m_factory_2;
+    std::vector<entry> m_entries;
+    uint64_t m_display_change_count{};
+};
+
 } // namespace cui::dwrite_utils
@@ -0,0 +1,154 @@
+#include "ui_extension.h"
+
+#if CUI_SDK_DWRITE_ENABLED
+
+namespace cui::fonts {
+
+font_fallback_cache& font_fallback_cache::s_get()
+{
+    static font_fallback_cache cache;
+    return cache;
+}
+
+font_fallback_cache::font_fallback_cache()
+{
+    if (manager_v3::ptr api; fb2k::std_api_try_get(api))
+        add_callback_token(api->on_default_font_fallback_changed(
+            fb2k::service_new<lambda_basic_callback>([] { s_get().invalidate(); })));
+}
+
+HRESULT font_fallback_cache::get_default_font_fallback(IDWriteFontFallback** font_fallback) noexcept
+{
+    *font_fallback = nullptr;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (m_default_entry)
+            return s_return_entry(*m_default_entry, font_fallback);
+    }
+
+    manager_v3::ptr api;
+    if (!fb2k::std_api_try_get(api))
+        return E_NOINTERFACE;
+
+    try {
+        entry new_entry;
+        new_entry.result = api->get_default_font_fallback(new_entry.font_fallback.receive_ptr());
+
+        if (FAILED(new_entry.result))
+            return new_entry.result;
+
+        std::scoped_lock lock(m_mutex);
+
+        if (!is_shut_down())
+            m_default_entry = new_entry;
+
+        return s_return_entry(new_entry, font_fallback);
+    } catch (const std::bad_alloc&) {
+        return E_OUTOFMEMORY;
+    } catch (const std::exception&) {
+        return E_FAIL;
+    }
+}
+
+HRESULT font_fallback_cache::get_font_fallback(GUID font_id, IDWriteFontFallback** font_fallback) noexcept
+{
+    *font_fallback = nullptr;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        const auto iter = std::ranges::find(m_font_entries, font_id, [](const auto& item) { return item.first; });
+
+        if (iter != m_font_entries.end())
+            return s_return_entry(iter->second, font_fallback);
+    }
+
+    manager_v3::ptr api;
+    if (!fb2k::std_api_try_get(api))
+        return E_NOINTERFACE;
+
+    try {
+        font::ptr font_ptr;
+
+        try {
+            font_ptr = api->get_font(font_id);
+        } catch (const exception_font_client_not_found&) {
+            return E_INVALIDARG;
+        }
+
+        register_font_callback(api, font_id);
+
+        entry new_entry;
+        new_entry.result = font_ptr->create_font_fallback(new_entry.font_fallback.receive_ptr());
+
+        if (FAILED(new_entry.result))
+            return new_entry.result;
+
+        std::scoped_lock lock(m_mutex);
+
+        const auto iter = std::ranges::find(m_font_entries, font_id, [](const auto& item) { return item.first; });
+
+        if (iter != m_font_entries.end())
+            iter->second = new_entry;
+        else if (!is_shut_down())
+            m_font_entries.emplace_back(font_id, new_entry);
+
+        return s_return_entry(new_entry, font_fallback);
+    } catch (const std::bad_alloc&) {
+        return E_OUTOFMEMORY;
+    } catch (const std::exception&) {
+        return E_FAIL;
+    }
+}
+
+void font_fallback_cache::invalidate()
+{
+    std::optional<entry> default_entry;
+    std::vector<std::pair<GUID, entry>> font_entries;
+
+    // The entries are released after the lock is released
+    std::scoped_lock lock(m_mutex);
+    default_entry = std::move(m_default_entry);
+    m_default_entry.reset();
+    font_entries = std::move(m_font_entries);
+    m_font_entries.clear();
+}
+
+HRESULT font_fallback_cache::s_return_entry(const entry& cached_entry, IDWriteFontFallback** font_fallback) noexcept
+{
+    *font_fallback = cached_entry.font_fallback.get_ptr();
+
+    if (*font_fallback)
+        (*font_fallback)->AddRef();
+
+    return cached_entry.result;
+}
+
+void font_fallback_cache::register_font_callback(const manager_v3::ptr& api, GUID font_id)
+{
+    if (!claim_font_callbacks(font_id))
+        return;
+
+    add_callback_token(api->on_font_changed(
+        font_id, fb2k::service_new<lambda_basic_callback>([font_id] { s_get().invalidate_font(font_id); })));
+}
+
+void font_fallback_cache::invalidate_font(GUID font_id)
+{
+    std::vector<std::pair<GUID, entry>> font_entries;
+
+    std::scoped_lock lock(m_mutex);
+
+    for (auto& item : m_font_entries) {
+        if (item.first == font_id)
+            font_entries.emplace_back(std::move(item));
+    }
+
+    std::erase_if(m_font_entries, [font_id](const auto& item) { return item.first == font_id; });
+}
+
+} // namespace cui::fonts
+
+#endif
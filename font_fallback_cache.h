@@ -0,0 +1,84 @@
+#pragma once
+
+namespace cui::fonts {
+
+/**
+ * \brief Shares DirectWrite font fallback objects between all windows in a module.
+ *
+ * Font fallback objects returned by manager_v3::get_default_font_fallback() and font::create_font_fallback() are
+ * created once, and shared until Columns UI reports that they have changed (via
+ * manager_v3::on_default_font_fallback_changed() and manager_v3::on_font_changed()). As font fallback objects for
+ * fonts are built on the default font fallback object, all of them are released when the default one changes. They
+ * are also released when foobar2000 is shutting down.
+ *
+ * As with the methods they wrap, `S_FALSE` is returned and `*font_fallback` is set to `nullptr` if a custom font
+ * fallback object is not in use.
+ *
+ * \note Requires Columns UI 3.0.0 or newer.
+ */
+class font_fallback_cache final : public shared_cache_base {
+public:
+    static font_fallback_cache& s_get();
+
+    /**
+     * Get the default Columns UI font fallback object.
+     *
+     * \param font_fallback  receives the font fallback object, with a reference added, or `nullptr`
+     * \return               HRESULT indicating success or failure code. `E_NOINTERFACE` is returned if a compatible
+     *                       version of Columns UI is not installed.
+     *
+     * \see manager_v3::get_default_font_fallback()
+     */
+    [[nodiscard]] HRESULT get_default_font_fallback(IDWriteFontFallback** font_fallback) noexcept;
+
+    /**
+     * Get the font fallback object for a font.
+     *
+     * \param font_id        GUID of the font client or common font
+     * \param font_fallback  receives the font fallback object, with a reference added, or `nullptr`
+     * \return               HRESULT indicating success or failure code. `E_NOINTERFACE` is returned if a compatible
+     *                       version of Columns UI is not installed, and `E_INVALIDARG` if font_id is not valid.
+     *
+     * \see font::create_font_fallback()
+     */
+    [[nodiscard]] HRESULT get_font_fallback(GUID font_id, IDWriteFontFallback** font_fallback) noexcept;
+
+    /** Release all font fallback objects. */
+    void invalidate();
+
+#ifdef __WIL_COM_INCLUDED
+    wil::com_ptr<IDWriteFontFallback> try_get_wil_default_font_fallback() noexcept
+    {
+        wil::com_ptr<IDWriteFontFallback> font_fallback;
+        (void)get_default_font_fallback(&font_fallback);
+        return font_fallback;
+    }
+
+    wil::com_ptr<IDWriteFontFallback> try_get_wil_font_fallback(GUID font_id) noexcept
+    {
+        wil::com_ptr<IDWriteFontFallback> font_fallback;
+        (void)get_font_fallback(font_id, &font_fallback);
+        return font_fallback;
+    }
+#endif
+
+private:
+    struct entry {
+        HRESULT result{};
+        pfc::com_ptr_t<IDWriteFontFallback> font_fallback;
+    };
+
+    font_fallback_cache();
+
+    static HRESULT s_return_entry(const entry& cached_entry, IDWriteFontFallback** font_fallback) noexcept;
+
+    void on_shutdown() override { invalidate(); }
+    void register_font_callback(const manager_v3::ptr& api, GUID font_id);
+    void invalidate_font(GUID font_id);
+
+    std::mutex m_mutex;
+    std::optional<entry> m_default_entry;
+    std::vector<std::pair<GUID, entry>> m_font_entries;
+};
+
+} // namespace cui::fonts
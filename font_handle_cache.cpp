@@ -0,0 +1,98 @@
+#include "ui_extension.h"
+
+namespace cui::fonts {
+
+font_handle_cache& font_handle_cache::s_get()
+{
+    static font_handle_cache cache;
+    return cache;
+}
+
+shared_font_handle font_handle_cache::acquire_font(const LOGFONT& log_font, unsigned dpi)
+{
+    const auto font_key = s_make_key(log_font, dpi);
+
+    std::scoped_lock lock(m_mutex);
+
+    auto& [weak_font, font] = m_fonts[font_key];
+
+    if (auto existing_font = weak_font.lock()) {
+        if (!is_shut_down())
+            font = existing_font;
+
+        return existing_font;
+    }
+
+    shared_font_handle new_font(CreateFontIndirect(&font_key.log_font), [](HFONT font) {
+        if (font)
+            DeleteObject(font);
+    });
+
+    weak_font = new_font;
+
+    if (!is_shut_down())
+        font = new_font;
+
+    return new_font;
+}
+
+shared_font_handle font_handle_cache::acquire_font(GUID font_id, unsigned dpi)
+{
+    register_callbacks(font_id);
+    return acquire_font(log_font_cache::s_get().get_log_font(font_id, dpi), dpi);
+}
+
+void font_handle_cache::invalidate()
+{
+    std::vector<shared_font_handle> released_fonts;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        for (auto& [font_key, font_entry] : m_fonts) {
+            if (font_entry.font)
+                released_fonts.emplace_back(std::move(font_entry.font));
+        }
+    }
+
+    // Fonts not in use elsewhere are deleted here, outside of the lock
+    released_fonts.clear();
+
+    std::scoped_lock lock(m_mutex);
+    std::erase_if(m_fonts, [](auto& item) { return item.second.weak_font.expired(); });
+}
+
+size_t font_handle_cache::get_font_count()
+{
+    std::scoped_lock lock(m_mutex);
+    return std::ranges::count_if(m_fonts, [](auto& item) { return !item.second.weak_font.expired(); });
+}
+
+font_handle_cache::key font_handle_cache::s_make_key(const LOGFONT& log_font, unsigned dpi)
+{
+    key font_key{log_font, dpi};
+
+    // Make sure any data after the null terminator of the face name doesn't affect comparisons
+    const auto face_name_length = wcsnlen(font_key.log_font.lfFaceName, LF_FACESIZE);
+    std::fill(std::begin(font_key.log_font.lfFaceName) + face_name_length, std::end(font_key.log_font.lfFaceName),
+        L'\0');
+
+    return font_key;
+}
+
+void font_handle_cache::register_callbacks(GUID font_id)
+{
+#if CUI_SDK_DWRITE_ENABLED
+    manager_v3::ptr api;
+    if (!fb2k::std_api_try_get(api) || !claim_font_callbacks(font_id))
+        return;
+
+    try {
+        add_callback_token(
+            api->on_font_changed(font_id, fb2k::service_new<lambda_basic_callback>([] { s_get().invalidate(); })));
+    } catch (const exception_font_client_not_found&) {
+    }
+#endif
+}
+
+} // namespace cui::fonts
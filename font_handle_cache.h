@@ -0,0 +1,103 @@
+#pragma once
+
+namespace cui::fonts {
+
+/**
+ * Shared, reference-counted font handle.
+ *
+ * The font is deleted when the last reference to it is released. Do not call DeleteObject on the handle.
+ */
+using shared_font_handle = std::shared_ptr<std::remove_pointer_t<HFONT>>;
+
+/**
+ * \brief Shares identical GDI fonts between all windows in a module.
+ *
+ * Fonts are keyed by their LOGFONT structure and a DPI value, so two requests for the same font return the same
+ * handle.
+ *
+ * The cache keeps every font it creates alive until a font change notification is received from Columns UI (via
+ * common_callback::on_font_changed() and, with Columns UI 3.0.0 or newer, manager_v3::on_font_changed()).
+ * After that, fonts that are still in use continue to be shared until they are released by everyone using them.
+ *
+ * \note Because fonts are keyed by their LOGFONT, a font returned by this class never becomes incorrect for the
+ * LOGFONT it was requested with. When fonts change, get the new LOGFONT (or call acquire_font() with a font ID)
+ * again.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * m_font = cui::fonts::font_handle_cache::s_get().acquire_font(my_font_client_id, m_dpi);
+ * SelectFont(dc, m_font.get());
+ * \endcode
+ */
+class font_handle_cache final : public shared_cache_base {
+public:
+    static font_handle_cache& s_get();
+
+    /**
+     * Get a font for a LOGFONT.
+     *
+     * \param log_font  the font
+     * \param dpi       the DPI log_font was created for
+     * \return          shared font handle
+     */
+    shared_font_handle acquire_font(const LOGFONT& log_font, unsigned dpi = USER_DEFAULT_SCREEN_DPI);
+
+    /**
+     * Get a font for a particular font client or common font at a particular DPI, falling back to the system icon
+     * font if Columns UI is not installed.
+     *
+     * \param font_id  GUID of the font client or common font
+     * \param dpi      DPI to create the font for
+     * \return         shared font handle
+     *
+     * \see log_font_cache::get_log_font()
+     */
+    shared_font_handle acquire_font(GUID font_id, unsigned dpi);
+
+    /** Stop keeping unused fonts alive. Fonts still in use remain shared. */
+    void invalidate();
+
+    /** Get the number of fonts that are currently alive. */
+    [[nodiscard]] size_t get_font_count();
+
+private:
+    struct key {
+        LOGFONT log_font{};
+        unsigned dpi{};
+
+        bool operator==(const key& other) const
+        {
+            return std::memcmp(&log_font, &other.log_font, sizeof(LOGFONT)) == 0 && dpi == other.dpi;
+        }
+    };
+
+    struct key_hasher {
+        size_t operator()(const key& value) const noexcept
+        {
+            return std::hash<std::string_view>()(
+                std::string_view(reinterpret_cast<const char*>(&value), sizeof(key)));
+        }
+    };
+
+    struct entry {
+        std::weak_ptr<std::remove_pointer_t<HFONT>> weak_font;
+        shared_font_handle font;
+    };
+
+    class font_callback : public common_callback {
+    public:
+        void on_font_changed(uint32_t changed_items_mask) const override { s_get().invalidate(); }
+    };
+
+    font_handle_cache() { register_common_callback<manager>(std::make_shared<font_callback>()); }
+
+    static key s_make_key(const LOGFONT& log_font, unsigned dpi);
+
+    void on_shutdown() override { invalidate(); }
+    void register_callbacks(GUID font_id);
+
+    std::mutex m_mutex;
+    std::unordered_map<key, entry, key_hasher> m_fonts;
+};
+
+} // namespace cui::fonts
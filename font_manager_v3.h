@@ -172,27 +172,14 @@ public:
     HRESULT create_rendering_params(
         IDWriteFactory* factory, HMONITOR monitor, IDWriteRenderingParams** rendering_params) const noexcept override
     {
-        if (!m_rendering_params.is_valid() || m_last_monitor != monitor) {
-            const HRESULT hr = dwrite_utils::create_custom_rendering_params(
-                factory, monitor, m_rendering_mode, m_rendering_params.receive_ptr());
-
-            if (FAILED(hr))
-                return hr;
-
-            m_last_monitor = monitor;
-        }
-
-        *rendering_params = m_rendering_params.get_ptr();
-        (*rendering_params)->AddRef();
-        return S_OK;
+        return m_rendering_params_cache.get_rendering_params(factory, monitor, m_rendering_mode, rendering_params);
     }
 
 private:
     DWRITE_RENDERING_MODE m_rendering_mode{DWRITE_RENDERING_MODE_DEFAULT};
     bool m_use_greyscale_antialiasing{};
     bool m_use_colour_glyphs{true};
-    mutable HMONITOR m_last_monitor{};
-    mutable pfc::com_ptr_t<IDWriteRenderingParams> m_rendering_params;
+    mutable dwrite_utils::rendering_params_cache m_rendering_params_cache;
 };
 
 /**
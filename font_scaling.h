@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * \file font_scaling.h
+ * \brief Scaling of font sizes between DPIs
+ *
+ * This header only depends on the standard library, so that it can be built and tested on other platforms.
+ */
+
+#include <cstdint>
+
+namespace cui::fonts {
+
+/**
+ * Scale a font height (or width) from one DPI to another.
+ *
+ * Results are rounded to the nearest integer, with halves rounded away from zero (as with MulDiv()). The sign of
+ * the height is preserved, so both cell heights and character heights can be scaled.
+ *
+ * \param height    height at from_dpi
+ * \param from_dpi  DPI the height is currently for
+ * \param to_dpi    DPI to scale the height to
+ * \return          height at to_dpi, or height unchanged if from_dpi is zero
+ */
+[[nodiscard]] constexpr long scale_font_height(long height, unsigned from_dpi, unsigned to_dpi)
+{
+    if (from_dpi == 0 || from_dpi == to_dpi)
+        return height;
+
+    const auto product = static_cast<int64_t>(height) * static_cast<int64_t>(to_dpi);
+    const auto half_divisor = static_cast<int64_t>(from_dpi / 2);
+    const auto rounded = product >= 0 ? product + half_divisor : product - half_divisor;
+
+    return static_cast<long>(rounded / static_cast<int64_t>(from_dpi));
+}
+
+} // namespace cui::fonts
@@ -25,6 +25,9 @@ namespace cui::fonts {
  *
  * \param font_id GUID of the font client or common font
  * \return HFONT handle. The caller must delete it using DeleteObject when it’s no longer required.
+ *
+ * \see font_handle_cache::acquire_font() to share identical fonts between windows instead of creating a new font
+ * on every call
  */
 [[nodiscard]] HFONT create_hfont_with_fallback(GUID font_id);
 
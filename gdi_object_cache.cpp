@@ -0,0 +1,130 @@
+#include "ui_extension.h"
+
+namespace cui::colours {
+
+HBRUSH client_gdi_objects::get_brush(colour_identifier_t identifier)
+{
+    if (m_owner.is_shut_down())
+        return nullptr;
+
+    update_snapshot();
+
+    auto& entry = m_brushes[identifier];
+
+    if (!entry.brush) {
+        entry.colour = m_snapshot->get_colour(identifier);
+        entry.brush = CreateSolidBrush(entry.colour);
+        ++m_stats.brushes_created;
+    }
+
+    return entry.brush;
+}
+
+HPEN client_gdi_objects::get_pen(colour_identifier_t identifier, int width, int style)
+{
+    if (m_owner.is_shut_down())
+        return nullptr;
+
+    update_snapshot();
+
+    auto& entry = m_pens[{identifier, width, style}];
+
+    if (!entry.pen) {
+        entry.colour = m_snapshot->get_colour(identifier);
+        entry.pen = CreatePen(style, width, entry.colour);
+        ++m_stats.pens_created;
+    }
+
+    return entry.pen;
+}
+
+const snapshot& client_gdi_objects::get_snapshot()
+{
+    update_snapshot();
+    return *m_snapshot;
+}
+
+void client_gdi_objects::release_all()
+{
+    for (auto& entry : m_brushes)
+        release_brush(entry);
+
+    for (auto& [_, entry] : m_pens)
+        release_pen(entry);
+
+    m_pens.clear();
+    m_snapshot = nullptr;
+}
+
+void client_gdi_objects::update_snapshot()
+{
+    auto current_snapshot = m_snapshot_helper.get();
+
+    if (current_snapshot == m_snapshot)
+        return;
+
+    m_snapshot = std::move(current_snapshot);
+
+    for (size_t index{}; index < m_brushes.size(); ++index) {
+        auto& entry = m_brushes[index];
+
+        if (entry.brush && entry.colour != m_snapshot->get_colour(static_cast<colour_identifier_t>(index)))
+            release_brush(entry);
+    }
+
+    std::erase_if(m_pens, [this](auto& item) {
+        auto& [key, entry] = item;
+
+        if (entry.colour == m_snapshot->get_colour(key.identifier))
+            return false;
+
+        release_pen(entry);
+        return true;
+    });
+}
+
+void client_gdi_objects::release_brush(brush_entry& entry)
+{
+    if (!entry.brush)
+        return;
+
+    DeleteObject(entry.brush);
+    entry.brush = nullptr;
+    ++m_stats.brushes_released;
+}
+
+void client_gdi_objects::release_pen(pen_entry& entry)
+{
+    if (!entry.pen)
+        return;
+
+    DeleteObject(entry.pen);
+    entry.pen = nullptr;
+    ++m_stats.pens_released;
+}
+
+gdi_object_cache& gdi_object_cache::s_get()
+{
+    static gdi_object_cache cache;
+    return cache;
+}
+
+client_gdi_objects& gdi_object_cache::get_client_objects(const GUID& client_id)
+{
+    const auto iter = std::ranges::find(m_clients, client_id, [](auto& item) { return item.first; });
+
+    if (iter != m_clients.end())
+        return *iter->second;
+
+    auto& [_, objects]
+        = m_clients.emplace_back(client_id, std::make_unique<client_gdi_objects>(client_id, m_stats, *this));
+    return *objects;
+}
+
+void gdi_object_cache::release_all()
+{
+    for (auto& [_, objects] : m_clients)
+        objects->release_all();
+}
+
+} // namespace cui::colours
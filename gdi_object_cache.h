@@ -0,0 +1,157 @@
+#pragma once
+
+namespace cui::colours {
+
+/** \brief Counters for GDI objects created and released by a gdi_object_cache. */
+struct gdi_object_cache_stats {
+    uint64_t brushes_created{};
+    uint64_t brushes_released{};
+    uint64_t pens_created{};
+    uint64_t pens_released{};
+};
+
+/**
+ * \brief Brushes and pens for the colours of a colour client.
+ *
+ * Objects are created when first requested, and are owned by this object. They are recreated only when the colour
+ * they were created from changes (including when the dark mode status changes).
+ *
+ * Instances are obtained using gdi_object_cache::get_client_objects().
+ *
+ * Once the cache owning this object has been shut down (when foobar2000 is shutting down), no more objects are
+ * created, and `nullptr` is returned instead.
+ *
+ * \note Returned handles remain valid until the next colour change notification, so they should not be held on to
+ * outside of the painting code using them. Do not delete the returned handles.
+ */
+class client_gdi_objects {
+public:
+    /**
+     * \param client_id  client GUID (null GUID implies global settings)
+     * \param stats      counters to update
+     * \param owner      cache whose shutdown stops further objects being created
+     */
+    client_gdi_objects(const GUID& client_id, gdi_object_cache_stats& stats, const shared_cache_base& owner)
+        : m_snapshot_helper(client_id)
+        , m_stats(stats)
+        , m_owner(owner)
+    {
+    }
+
+    ~client_gdi_objects() { release_all(); }
+
+    client_gdi_objects(const client_gdi_objects&) = delete;
+    client_gdi_objects& operator=(const client_gdi_objects&) = delete;
+
+    /**
+     * Get a solid brush for a colour.
+     *
+     * \param identifier  the colour
+     * \return            the brush, or `nullptr` if the cache has been shut down
+     */
+    HBRUSH get_brush(colour_identifier_t identifier);
+
+    /**
+     * Get a pen for a colour.
+     *
+     * \param identifier  the colour
+     * \param width       width of the pen, in pixels
+     * \param style       pen style, as passed to `CreatePen()`
+     * \return            the pen, or `nullptr` if the cache has been shut down
+     */
+    HPEN get_pen(colour_identifier_t identifier, int width = 1, int style = PS_SOLID);
+
+    /** Get the colour snapshot the current objects were created from. */
+    const snapshot& get_snapshot();
+
+    /** Release all brushes and pens. */
+    void release_all();
+
+private:
+    struct brush_entry {
+        HBRUSH brush{};
+        COLORREF colour{};
+    };
+
+    struct pen_key {
+        colour_identifier_t identifier{};
+        int width{};
+        int style{};
+
+        auto operator<=>(const pen_key&) const = default;
+    };
+
+    struct pen_entry {
+        HPEN pen{};
+        COLORREF colour{};
+    };
+
+    void update_snapshot();
+    void release_brush(brush_entry& entry);
+    void release_pen(pen_entry& entry);
+
+    const snapshot_helper m_snapshot_helper;
+    gdi_object_cache_stats& m_stats;
+    const shared_cache_base& m_owner;
+    std::shared_ptr<const snapshot> m_snapshot;
+    std::array<brush_entry, snapshot::colour_count> m_brushes{};
+    std::map<pen_key, pen_entry> m_pens;
+};
+
+/**
+ * \brief Shared cache of brushes and pens for colour clients.
+ *
+ * This avoids creating and destroying brushes and pens every time a window is painted.
+ *
+ * \note This class is not thread-safe, and should only be used from the main thread.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * auto& gdi_objects = cui::colours::gdi_object_cache::s_get().get_client_objects(my_client_id);
+ * FillRect(dc, &rect, gdi_objects.get_brush(cui::colours::colour_background));
+ * \endcode
+ */
+class gdi_object_cache final : public shared_cache_base {
+public:
+    static gdi_object_cache& s_get();
+
+    /**
+     * Get the brushes and pens for a colour client.
+     *
+     * \param client_id  client GUID (null GUID implies global settings)
+     * \return           the brushes and pens of the client; this remains valid until the module is unloaded
+     */
+    client_gdi_objects& get_client_objects(const GUID& client_id = GUID{});
+
+    /**
+     * Shortcut for get_client_objects(client_id).get_brush(identifier).
+     */
+    HBRUSH get_brush(const GUID& client_id, colour_identifier_t identifier)
+    {
+        return get_client_objects(client_id).get_brush(identifier);
+    }
+
+    /**
+     * Shortcut for get_client_objects(client_id).get_pen(identifier, width, style).
+     */
+    HPEN get_pen(const GUID& client_id, colour_identifier_t identifier, int width = 1, int style = PS_SOLID)
+    {
+        return get_client_objects(client_id).get_pen(identifier, width, style);
+    }
+
+    /** Release all brushes and pens. Called automatically when foobar2000 is shutting down. */
+    void release_all();
+
+    /** Get the number of brushes and pens created and released so far. */
+    [[nodiscard]] gdi_object_cache_stats get_stats() const { return m_stats; }
+
+private:
+    gdi_object_cache() = default;
+
+    void on_shutdown() override { release_all(); }
+
+    gdi_object_cache_stats m_stats;
+    std::vector<std::pair<GUID, std::unique_ptr<client_gdi_objects>>> m_clients;
+};
+
+} // namespace cui::colours
@@ -0,0 +1,150 @@
+#include "ui_extension.h"
+
+namespace cui::fonts {
+
+namespace {
+
+unsigned get_system_dpi()
+{
+    const auto dc = GetDC(nullptr);
+    const auto dpi = GetDeviceCaps(dc, LOGPIXELSY);
+    ReleaseDC(nullptr, dc);
+    return static_cast<unsigned>(dpi);
+}
+
+} // namespace
+
+/** Counts a get_log_font() call as in progress, so that entries it can reach are not deleted. */
+class log_font_cache::reader_scope {
+public:
+    explicit reader_scope(log_font_cache& cache) : m_cache(cache) { m_cache.m_reader_count.fetch_add(1); }
+
+    ~reader_scope()
+    {
+        if (m_cache.m_reader_count.fetch_sub(1) == 1 && m_cache.m_has_retired_heads.load())
+            m_cache.delete_retired_heads_if_unused();
+    }
+
+    reader_scope(const reader_scope&) = delete;
+    reader_scope& operator=(const reader_scope&) = delete;
+
+private:
+    log_font_cache& m_cache;
+};
+
+log_font_cache& log_font_cache::s_get()
+{
+    static log_font_cache cache;
+    return cache;
+}
+
+log_font_cache::~log_font_cache()
+{
+    s_delete_entries(m_head.exchange(nullptr));
+
+    for (const auto retired_head : m_retired_heads)
+        s_delete_entries(retired_head);
+}
+
+LOGFONT log_font_cache::get_log_font(GUID font_id, unsigned dpi)
+{
+    reader_scope scope(*this);
+    auto head = m_head.load(std::memory_order_acquire);
+
+    for (auto item = head; item; item = item->next) {
+        if (item->font_id == font_id && item->dpi == dpi)
+            return item->log_font;
+    }
+
+    register_callbacks(font_id);
+
+    auto new_entry = std::make_unique<entry>(entry{font_id, dpi, s_create_log_font(font_id, dpi)});
+    const auto log_font = new_entry->log_font;
+
+    do {
+        new_entry->next = head;
+    } while (
+        !m_head.compare_exchange_weak(head, new_entry.get(), std::memory_order_acq_rel, std::memory_order_acquire));
+
+    new_entry.release();
+    return log_font;
+}
+
+void log_font_cache::invalidate()
+{
+    // Readers may still be using the old entries, so they are only deleted once no readers are in progress
+    const auto old_head = m_head.exchange(nullptr);
+
+    if (!old_head)
+        return;
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_retired_heads.emplace_back(old_head);
+        m_has_retired_heads.store(true);
+    }
+
+    delete_retired_heads_if_unused();
+}
+
+void log_font_cache::delete_retired_heads_if_unused()
+{
+    std::vector<entry*> retired_heads;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        // Readers that started after the heads were retired can't reach them, so if no readers are in progress
+        // now, nothing can be using them
+        if (m_reader_count.load() != 0)
+            return;
+
+        retired_heads = std::move(m_retired_heads);
+        m_retired_heads.clear();
+        m_has_retired_heads.store(false);
+    }
+
+    for (const auto retired_head : retired_heads)
+        s_delete_entries(retired_head);
+}
+
+LOGFONT log_font_cache::s_create_log_font(GUID font_id, unsigned dpi)
+{
+    if (manager_v2::ptr api; fb2k::std_api_try_get(api)) {
+        if (font_id == items_font_id)
+            return api->get_common_font(font_type_items, dpi);
+
+        if (font_id == labels_font_id)
+            return api->get_common_font(font_type_labels, dpi);
+
+        return api->get_client_font(font_id, dpi);
+    }
+
+    return scale_log_font(get_log_font_with_fallback(font_id), get_system_dpi(), dpi);
+}
+
+void log_font_cache::s_delete_entries(entry* head)
+{
+    while (head) {
+        const auto next = head->next;
+        delete head;
+        head = next;
+    }
+}
+
+void log_font_cache::register_callbacks(GUID font_id)
+{
+#if CUI_SDK_DWRITE_ENABLED
+    manager_v3::ptr api_v3;
+    if (!fb2k::std_api_try_get(api_v3) || !claim_font_callbacks(font_id))
+        return;
+
+    try {
+        add_callback_token(
+            api_v3->on_font_changed(font_id, fb2k::service_new<lambda_basic_callback>([] { s_get().invalidate(); })));
+    } catch (const exception_font_client_not_found&) {
+    }
+#endif
+}
+
+} // namespace cui::fonts
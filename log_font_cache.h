@@ -0,0 +1,83 @@
+#pragma once
+
+namespace cui::fonts {
+
+/**
+ * Scale the height and width of a LOGFONT from one DPI to another.
+ *
+ * \see scale_font_height()
+ */
+[[nodiscard]] constexpr LOGFONT scale_log_font(LOGFONT log_font, unsigned from_dpi, unsigned to_dpi)
+{
+    log_font.lfHeight = scale_font_height(log_font.lfHeight, from_dpi, to_dpi);
+    log_font.lfWidth = scale_font_height(log_font.lfWidth, from_dpi, to_dpi);
+    return log_font;
+}
+
+/**
+ * \brief Remembers the LOGFONT of each font at each DPI it has been requested for.
+ *
+ * This avoids calling into Columns UI every time a window needs a font (for example, when a window moves between
+ * monitors with different DPIs).
+ *
+ * The first lookup of a font at a particular DPI uses manager_v2 (falling back to the system icon font, scaled
+ * to the requested DPI, if Columns UI is not installed). Later lookups do not take any locks.
+ *
+ * Remembered fonts are cleared when Columns UI reports a font change through common_callback::on_font_changed()
+ * and, with Columns UI 3.0.0 or newer, manager_v3::on_font_changed().
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * const auto log_font = cui::fonts::log_font_cache::s_get().get_log_font(my_font_client_id, GetDpiForWindow(wnd));
+ * \endcode
+ */
+class log_font_cache final : public shared_cache_base {
+public:
+    static log_font_cache& s_get();
+
+    /**
+     * Get the LOGFONT for a font client or common font at a particular DPI.
+     *
+     * \param font_id  GUID of the font client or common font
+     * \param dpi      DPI to get the font for
+     * \return         populated LOGFONT structure
+     */
+    [[nodiscard]] LOGFONT get_log_font(GUID font_id, unsigned dpi = USER_DEFAULT_SCREEN_DPI);
+
+    /** Forget all remembered fonts. */
+    void invalidate();
+
+private:
+    struct entry {
+        GUID font_id{};
+        unsigned dpi{};
+        LOGFONT log_font{};
+        entry* next{};
+    };
+
+    class font_callback : public common_callback {
+    public:
+        void on_font_changed(uint32_t changed_items_mask) const override { s_get().invalidate(); }
+    };
+
+    log_font_cache() { register_common_callback<manager>(std::make_shared<font_callback>()); }
+    ~log_font_cache() override;
+
+    class reader_scope;
+
+    static LOGFONT s_create_log_font(GUID font_id, unsigned dpi);
+    static void s_delete_entries(entry* head);
+
+    void on_shutdown() override { invalidate(); }
+    void register_callbacks(GUID font_id);
+    void delete_retired_heads_if_unused();
+
+    std::atomic<entry*> m_head{};
+    /** Number of get_log_font() calls in progress. Retired entries are deleted when this is zero. */
+    std::atomic<size_t> m_reader_count{};
+    std::atomic<bool> m_has_retired_heads{};
+    std::mutex m_mutex;
+    std::vector<entry*> m_retired_heads;
+};
+
+} // namespace cui::fonts
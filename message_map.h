@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * \file message_map.h
+ * \brief Compile-time window message dispatch
+ *
+ * This header only uses `HWND`, `UINT`, `WPARAM`, `LPARAM`, `LRESULT` and `DefWindowProc()`, so that the dispatch
+ * code can be benchmarked on other platforms using stand-ins for them.
+ */
+
+namespace uie {
+
+/**
+ * \brief Entry in a message_map.
+ *
+ * \tparam Message  the window message
+ * \tparam Handler  pointer to the member function handling the message. It must have the signature
+ *                  `LRESULT (HWND wnd, UINT msg, WPARAM wp, LPARAM lp)`.
+ */
+template <UINT Message, auto Handler>
+struct message_entry {
+    static constexpr UINT message = Message;
+    static constexpr auto handler = Handler;
+};
+
+/**
+ * \brief Compile-time map from window messages to member function handlers.
+ *
+ * Messages are dispatched by a chain of comparisons generated at compile time (which the compiler can turn into a
+ * jump table), rather than through a `std::function`. Messages without an entry are passed to `DefWindowProc()`.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * class my_window {
+ * public:
+ *     my_window() : m_window(container_window_v3_config(L"my_window_class"), &map::s_dispatch, this) {}
+ *
+ * private:
+ *     LRESULT on_size(HWND wnd, UINT msg, WPARAM wp, LPARAM lp);
+ *     LRESULT on_paint(HWND wnd, UINT msg, WPARAM wp, LPARAM lp);
+ *
+ *     using map = uie::message_map<my_window, uie::message_entry<WM_SIZE, &my_window::on_size>,
+ *         uie::message_entry<WM_PAINT, &my_window::on_paint>>;
+ *
+ *     uie::container_window_v3 m_window;
+ * };
+ * \endcode
+ *
+ * \tparam Class    class containing the handler member functions
+ * \tparam Entries  one or more message_entry types
+ */
+template <class Class, class... Entries>
+struct message_map {
+    static LRESULT s_dispatch(Class& self, HWND wnd, UINT msg, WPARAM wp, LPARAM lp)
+    {
+        LRESULT result{};
+        const auto handled
+            = ((msg == Entries::message && (result = (self.*Entries::handler)(wnd, msg, wp, lp), true)) || ...);
+
+        return handled ? result : DefWindowProc(wnd, msg, wp, lp);
+    }
+
+    /** Can be used as the message dispatcher of a container_window_v3. */
+    static LRESULT s_dispatch(void* context, HWND wnd, UINT msg, WPARAM wp, LPARAM lp)
+    {
+        return s_dispatch(*static_cast<Class*>(context), wnd, msg, wp, lp);
+    }
+};
+
+} // namespace uie
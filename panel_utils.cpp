@@ -21,4 +21,30 @@ std::string get_remapped_category(const window::ptr& panel)
     return remap_category(category);
 }
 
+bool set_window_suspended(const window::ptr& window, bool suspended)
+{
+    window_v2::ptr window_v2;
+
+    if (!window->service_query_t(window_v2))
+        return false;
+
+    if (suspended)
+        window_v2->on_suspend();
+    else
+        window_v2->on_resume();
+
+    return true;
+}
+
+bool trim_window_memory(const window::ptr& window)
+{
+    window_v2::ptr window_v2;
+
+    if (!window->service_query_t(window_v2))
+        return false;
+
+    window_v2->on_trim_memory();
+    return true;
+}
+
 } // namespace uie::utils
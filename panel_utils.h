@@ -17,4 +17,21 @@ std::string remap_category(const char* category);
  */
 std::string get_remapped_category(const window::ptr& panel);
 
+/**
+ * Notifies a window that it has been hidden or shown by its host, if it implements uie::window_v2.
+ *
+ * \param window     the hosted window
+ * \param suspended  whether the window has been hidden
+ * \return           whether the window implements uie::window_v2
+ */
+bool set_window_suspended(const window::ptr& window, bool suspended);
+
+/**
+ * Asks a window to release caches and other memory it can recreate later, if it implements uie::window_v2.
+ *
+ * \param window  the hosted window
+ * \return        whether the window implements uie::window_v2
+ */
+bool trim_window_memory(const window::ptr& window);
+
 } // namespace uie::utils
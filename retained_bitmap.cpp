@@ -0,0 +1,60 @@
+#include "ui_extension.h"
+
+namespace uie::win32 {
+
+bool retained_bitmap::create(HDC reference_dc, SIZE size, bitmap_type type)
+{
+    if (is_size(size) && type == m_type)
+        return true;
+
+    release();
+
+    if (size.cx <= 0 || size.cy <= 0)
+        return false;
+
+    m_dc = CreateCompatibleDC(reference_dc);
+
+    if (type == bitmap_type::dib_section) {
+        BITMAPINFO bitmap_info{};
+        bitmap_info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bitmap_info.bmiHeader.biWidth = size.cx;
+        bitmap_info.bmiHeader.biHeight = -size.cy;
+        bitmap_info.bmiHeader.biPlanes = 1;
+        bitmap_info.bmiHeader.biBitCount = 32;
+        bitmap_info.bmiHeader.biCompression = BI_RGB;
+
+        void* bits{};
+        m_bitmap = CreateDIBSection(reference_dc, &bitmap_info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    } else {
+        m_bitmap = CreateCompatibleBitmap(reference_dc, size.cx, size.cy);
+    }
+
+    if (!m_dc || !m_bitmap) {
+        release();
+        return false;
+    }
+
+    m_previous_bitmap = SelectObject(m_dc, m_bitmap);
+    m_size = size;
+    m_type = type;
+    return true;
+}
+
+void retained_bitmap::release()
+{
+    if (m_dc && m_previous_bitmap)
+        SelectObject(m_dc, m_previous_bitmap);
+
+    if (m_bitmap)
+        DeleteObject(m_bitmap);
+
+    if (m_dc)
+        DeleteDC(m_dc);
+
+    m_dc = nullptr;
+    m_bitmap = nullptr;
+    m_previous_bitmap = nullptr;
+    m_size = {};
+}
+
+} // namespace uie::win32
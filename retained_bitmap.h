@@ -0,0 +1,55 @@
+#pragma once
+
+namespace uie::win32 {
+
+/**
+ * \brief A bitmap selected into a memory device context, kept between uses and recreated only when its size
+ * changes.
+ *
+ * Used by background_cache, visualisation_background_cache and double_buffered_visualisation_painter.
+ */
+class retained_bitmap {
+public:
+    enum class bitmap_type {
+        /** Bitmap created using `CreateCompatibleBitmap()`. */
+        compatible,
+        /** Top-down 32-bit DIB section. */
+        dib_section,
+    };
+
+    retained_bitmap() = default;
+    ~retained_bitmap() { release(); }
+
+    retained_bitmap(const retained_bitmap&) = delete;
+    retained_bitmap& operator=(const retained_bitmap&) = delete;
+
+    /**
+     * Create the bitmap, unless it already exists with the same size and type.
+     *
+     * \param reference_dc  device context the memory device context and bitmap are created compatible with
+     * \param size          size of the bitmap; must be positive
+     * \param type          type of bitmap to create
+     * \return              whether the bitmap exists
+     */
+    bool create(HDC reference_dc, SIZE size, bitmap_type type = bitmap_type::compatible);
+
+    /** Free the bitmap and memory device context. */
+    void release();
+
+    /** Get the memory device context the bitmap is selected into, or `nullptr` if the bitmap hasn't been created. */
+    [[nodiscard]] HDC get_dc() const { return m_dc; }
+
+    /** Get the size of the bitmap, or an empty size if it hasn't been created. */
+    [[nodiscard]] SIZE get_size() const { return m_size; }
+
+    [[nodiscard]] bool is_size(SIZE size) const { return m_dc && m_size.cx == size.cx && m_size.cy == size.cy; }
+
+private:
+    HDC m_dc{};
+    HBITMAP m_bitmap{};
+    HGDIOBJ m_previous_bitmap{};
+    SIZE m_size{};
+    bitmap_type m_type{};
+};
+
+} // namespace uie::win32
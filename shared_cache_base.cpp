@@ -0,0 +1,114 @@
+#include "ui_extension.h"
+
+namespace cui {
+
+namespace {
+
+struct shared_cache_list {
+    // Recursive, as caches may be created or destroyed while other caches are being shut down
+    std::recursive_mutex mutex;
+    std::vector<shared_cache_base*> caches;
+    bool is_quitting{};
+};
+
+shared_cache_list& get_shared_cache_list()
+{
+    static shared_cache_list list;
+    return list;
+}
+
+class shared_cache_initquit : public initquit {
+public:
+    void on_quit() noexcept override
+    {
+        auto& list = get_shared_cache_list();
+        std::scoped_lock lock(list.mutex);
+        list.is_quitting = true;
+
+        // Caches created later may depend on earlier ones, so they're shut down first
+        const auto caches = list.caches;
+
+        for (auto iter = caches.rbegin(); iter != caches.rend(); ++iter)
+            (*iter)->shutdown();
+    }
+};
+
+initquit_factory_t<shared_cache_initquit> g_shared_cache_initquit;
+
+} // namespace
+
+shared_cache_base::shared_cache_base()
+{
+    auto& list = get_shared_cache_list();
+    std::scoped_lock lock(list.mutex);
+
+    if (list.is_quitting)
+        m_is_shut_down = true;
+
+    list.caches.emplace_back(this);
+}
+
+shared_cache_base::~shared_cache_base()
+{
+    {
+        auto& list = get_shared_cache_list();
+        std::scoped_lock lock(list.mutex);
+        std::erase(list.caches, this);
+    }
+
+    std::vector<callback_token::ptr> callback_tokens;
+
+    {
+        std::scoped_lock lock(m_mutex);
+        callback_tokens = std::move(m_callback_tokens);
+    }
+}
+
+void shared_cache_base::shutdown()
+{
+    std::vector<callback_token::ptr> callback_tokens;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (m_is_shut_down.exchange(true, std::memory_order_acq_rel))
+            return;
+
+        callback_tokens = std::move(m_callback_tokens);
+        m_callback_tokens.clear();
+        m_callback_font_ids.clear();
+    }
+
+    // Released outside of the lock, as releasing a token may call back into this class
+    callback_tokens.clear();
+
+    on_shutdown();
+}
+
+bool shared_cache_base::add_callback_token(callback_token::ptr token)
+{
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (!is_shut_down()) {
+            m_callback_tokens.emplace_back(std::move(token));
+            return true;
+        }
+    }
+
+    // The token is released here, outside of the lock
+    return false;
+}
+
+bool shared_cache_base::claim_font_callbacks(const GUID& font_id)
+{
+    std::scoped_lock lock(m_mutex);
+
+    if (is_shut_down() || std::ranges::find(m_callback_font_ids, font_id) != m_callback_font_ids.end())
+        return false;
+
+    m_callback_font_ids.emplace_back(font_id);
+    return true;
+}
+
+} // namespace cui
@@ -0,0 +1,89 @@
+#pragma once
+
+namespace cui {
+
+/**
+ * \brief Base class for shared caches that listen for Columns UI changes until foobar2000 is shutting down.
+ *
+ * This handles the parts of the lifecycle that are the same for all caches in this SDK:
+ *
+ * - Callbacks registered using register_common_callback() and add_callback_token() are released by shutdown().
+ * - shutdown() is called for every instance when foobar2000 is shutting down, in the reverse order to which the
+ *   instances were created. Instances created after that start off shut down.
+ * - Once shut down, is_shut_down() returns true, and callbacks registered afterwards are released immediately.
+ *
+ * Derived classes release their cached objects in on_shutdown(), and should not add to the cache once
+ * is_shut_down() returns true.
+ *
+ * \note The member functions of this class are thread-safe.
+ */
+class shared_cache_base {
+public:
+    shared_cache_base(const shared_cache_base&) = delete;
+    shared_cache_base& operator=(const shared_cache_base&) = delete;
+
+    /**
+     * Release all callbacks and then call on_shutdown(), if that hasn't already been done.
+     *
+     * This is called automatically when foobar2000 is shutting down.
+     */
+    void shutdown();
+
+    [[nodiscard]] bool is_shut_down() const { return m_is_shut_down.load(std::memory_order_acquire); }
+
+protected:
+    shared_cache_base();
+
+    /**
+     * Releases any remaining callbacks.
+     *
+     * Derived classes whose callbacks use their members should call shutdown() in their destructor.
+     */
+    virtual ~shared_cache_base();
+
+    /** Called by shutdown() after all callbacks have been released. */
+    virtual void on_shutdown() {}
+
+    /**
+     * Keep a callback token until shutdown.
+     *
+     * \param token  the token
+     * \return       whether the token was kept. If already shut down, the token is released instead.
+     */
+    bool add_callback_token(callback_token::ptr token);
+
+    /**
+     * Register a colours::common_callback or fonts::common_callback, which is deregistered on shutdown.
+     *
+     * \tparam Manager   colours::manager or fonts::manager
+     * \param callback   the callback; it's kept alive until it has been deregistered
+     */
+    template <class Manager, class Callback>
+    void register_common_callback(std::shared_ptr<Callback> callback)
+    {
+        typename Manager::ptr api;
+
+        if (is_shut_down() || !fb2k::std_api_try_get(api))
+            return;
+
+        api->register_common_callback(callback.get());
+        add_callback_token(fb2k::service_new<lambda_callback_token>(
+            [api, callback{std::move(callback)}] { api->deregister_common_callback(callback.get()); }));
+    }
+
+    /**
+     * Record that callbacks for a font are about to be registered.
+     *
+     * \param font_id  GUID of the font client or common font
+     * \return         true the first time this is called for a font, unless already shut down
+     */
+    bool claim_font_callbacks(const GUID& font_id);
+
+private:
+    std::mutex m_mutex;
+    std::vector<callback_token::ptr> m_callback_tokens;
+    std::vector<GUID> m_callback_font_ids;
+    std::atomic<bool> m_is_shut_down{};
+};
+
+} // namespace cui
@@ -0,0 +1,508 @@
+// This file doesn't use the precompiled header, so that it can be built without the foobar2000 SDK
+#include "spectrum_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CUI_SDK_SPECTRUM_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define CUI_SDK_SPECTRUM_X86 0
+#endif
+
+#if CUI_SDK_SPECTRUM_X86 && defined(__GNUC__)
+#define CUI_SDK_SPECTRUM_AVX2_FUNCTION __attribute__((target("avx2,fma")))
+#else
+#define CUI_SDK_SPECTRUM_AVX2_FUNCTION
+#endif
+
+namespace uie::spectrum {
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+#if CUI_SDK_SPECTRUM_X86
+
+simd_level detect_simd_level() noexcept
+{
+#ifdef _MSC_VER
+    int registers[4]{};
+    __cpuid(registers, 0);
+
+    if (registers[0] >= 7) {
+        __cpuid(registers, 1);
+        const bool is_fma_supported = (registers[2] & (1 << 12)) != 0;
+        const bool is_osxsave_supported = (registers[2] & (1 << 27)) != 0;
+        const bool is_avx_supported = (registers[2] & (1 << 28)) != 0;
+
+        // Check that the OS saves the YMM registers. The AVX2 kernels also use FMA instructions.
+        if (is_fma_supported && is_osxsave_supported && is_avx_supported && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(registers, 7, 0);
+
+            if (registers[1] & (1 << 5))
+                return simd_level::avx2;
+        }
+    }
+
+    return simd_level::sse2;
+#else
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return simd_level::avx2;
+
+    return __builtin_cpu_supports("sse2") ? simd_level::sse2 : simd_level::scalar;
+#endif
+}
+
+#else
+
+simd_level detect_simd_level() noexcept
+{
+    return simd_level::scalar;
+}
+
+#endif
+
+// Scalar kernels
+
+void multiply_scalar(const float* left, const float* right, float* output, size_t count) noexcept
+{
+    for (size_t index{}; index < count; ++index)
+        output[index] = left[index] * right[index];
+}
+
+void magnitudes_scalar(const float* real, const float* imaginary, float* magnitudes, size_t count) noexcept
+{
+    for (size_t index{}; index < count; ++index)
+        magnitudes[index] = std::sqrt(real[index] * real[index] + imaginary[index] * imaginary[index]);
+}
+
+float maximum_scalar(const float* values, size_t count) noexcept
+{
+    float result = values[0];
+
+    for (size_t index{1}; index < count; ++index)
+        result = std::max(result, values[index]);
+
+    return result;
+}
+
+void falloff_scalar(float* current, const float* target, size_t count, float falloff) noexcept
+{
+    for (size_t index{}; index < count; ++index)
+        current[index] = std::max(target[index], current[index] - falloff);
+}
+
+void butterflies_scalar(float* real, float* imaginary, size_t size, size_t half_size, const float* twiddle_real,
+    const float* twiddle_imaginary) noexcept
+{
+    for (size_t start{}; start < size; start += half_size * 2) {
+        for (size_t offset{}; offset < half_size; ++offset) {
+            const auto top = start + offset;
+            const auto bottom = top + half_size;
+
+            const auto product_real
+                = real[bottom] * twiddle_real[offset] - imaginary[bottom] * twiddle_imaginary[offset];
+            const auto product_imaginary
+                = real[bottom] * twiddle_imaginary[offset] + imaginary[bottom] * twiddle_real[offset];
+
+            real[bottom] = real[top] - product_real;
+            imaginary[bottom] = imaginary[top] - product_imaginary;
+            real[top] += product_real;
+            imaginary[top] += product_imaginary;
+        }
+    }
+}
+
+#if CUI_SDK_SPECTRUM_X86
+
+// SSE2 kernels
+
+void multiply_sse2(const float* left, const float* right, float* output, size_t count) noexcept
+{
+    size_t index{};
+
+    for (; index + 4 <= count; index += 4)
+        _mm_storeu_ps(output + index, _mm_mul_ps(_mm_loadu_ps(left + index), _mm_loadu_ps(right + index)));
+
+    multiply_scalar(left + index, right + index, output + index, count - index);
+}
+
+void magnitudes_sse2(const float* real, const float* imaginary, float* magnitudes, size_t count) noexcept
+{
+    size_t index{};
+
+    for (; index + 4 <= count; index += 4) {
+        const auto real_values = _mm_loadu_ps(real + index);
+        const auto imaginary_values = _mm_loadu_ps(imaginary + index);
+        const auto sum_of_squares = _mm_add_ps(
+            _mm_mul_ps(real_values, real_values), _mm_mul_ps(imaginary_values, imaginary_values));
+        _mm_storeu_ps(magnitudes + index, _mm_sqrt_ps(sum_of_squares));
+    }
+
+    magnitudes_scalar(real + index, imaginary + index, magnitudes + index, count - index);
+}
+
+float maximum_sse2(const float* values, size_t count) noexcept
+{
+    if (count < 4)
+        return maximum_scalar(values, count);
+
+    auto result_values = _mm_loadu_ps(values);
+    size_t index{4};
+
+    for (; index + 4 <= count; index += 4)
+        result_values = _mm_max_ps(result_values, _mm_loadu_ps(values + index));
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, result_values);
+
+    auto result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+    for (; index < count; ++index)
+        result = std::max(result, values[index]);
+
+    return result;
+}
+
+void falloff_sse2(float* current, const float* target, size_t count, float falloff) noexcept
+{
+    const auto falloff_values = _mm_set1_ps(falloff);
+    size_t index{};
+
+    for (; index + 4 <= count; index += 4) {
+        const auto decayed = _mm_sub_ps(_mm_loadu_ps(current + index), falloff_values);
+        _mm_storeu_ps(current + index, _mm_max_ps(_mm_loadu_ps(target + index), decayed));
+    }
+
+    falloff_scalar(current + index, target + index, count - index, falloff);
+}
+
+void butterflies_sse2(float* real, float* imaginary, size_t size, size_t half_size, const float* twiddle_real,
+    const float* twiddle_imaginary) noexcept
+{
+    if (half_size < 4) {
+        butterflies_scalar(real, imaginary, size, half_size, twiddle_real, twiddle_imaginary);
+        return;
+    }
+
+    for (size_t start{}; start < size; start += half_size * 2) {
+        for (size_t offset{}; offset < half_size; offset += 4) {
+            const auto top = start + offset;
+            const auto bottom = top + half_size;
+
+            const auto w_real = _mm_loadu_ps(twiddle_real + offset);
+            const auto w_imaginary = _mm_loadu_ps(twiddle_imaginary + offset);
+            const auto bottom_real = _mm_loadu_ps(real + bottom);
+            const auto bottom_imaginary = _mm_loadu_ps(imaginary + bottom);
+            const auto top_real = _mm_loadu_ps(real + top);
+            const auto top_imaginary = _mm_loadu_ps(imaginary + top);
+
+            const auto product_real
+                = _mm_sub_ps(_mm_mul_ps(bottom_real, w_real), _mm_mul_ps(bottom_imaginary, w_imaginary));
+            const auto product_imaginary
+                = _mm_add_ps(_mm_mul_ps(bottom_real, w_imaginary), _mm_mul_ps(bottom_imaginary, w_real));
+
+            _mm_storeu_ps(real + bottom, _mm_sub_ps(top_real, product_real));
+            _mm_storeu_ps(imaginary + bottom, _mm_sub_ps(top_imaginary, product_imaginary));
+            _mm_storeu_ps(real + top, _mm_add_ps(top_real, product_real));
+            _mm_storeu_ps(imaginary + top, _mm_add_ps(top_imaginary, product_imaginary));
+        }
+    }
+}
+
+// AVX2 kernels
+
+CUI_SDK_SPECTRUM_AVX2_FUNCTION void multiply_avx2(
+    const float* left, const float* right, float* output, size_t count) noexcept
+{
+    size_t index{};
+
+    for (; index + 8 <= count; index += 8)
+        _mm256_storeu_ps(output + index, _mm256_mul_ps(_mm256_loadu_ps(left + index), _mm256_loadu_ps(right + index)));
+
+    multiply_sse2(left + index, right + index, output + index, count - index);
+}
+
+CUI_SDK_SPECTRUM_AVX2_FUNCTION void magnitudes_avx2(
+    const float* real, const float* imaginary, float* magnitudes, size_t count) noexcept
+{
+    size_t index{};
+
+    for (; index + 8 <= count; index += 8) {
+        const auto real_values = _mm256_loadu_ps(real + index);
+        const auto imaginary_values = _mm256_loadu_ps(imaginary + index);
+        const auto sum_of_squares
+            = _mm256_fmadd_ps(real_values, real_values, _mm256_mul_ps(imaginary_values, imaginary_values));
+        _mm256_storeu_ps(magnitudes + index, _mm256_sqrt_ps(sum_of_squares));
+    }
+
+    magnitudes_sse2(real + index, imaginary + index, magnitudes + index, count - index);
+}
+
+CUI_SDK_SPECTRUM_AVX2_FUNCTION float maximum_avx2(const float* values, size_t count) noexcept
+{
+    if (count < 8)
+        return maximum_sse2(values, count);
+
+    auto result_values = _mm256_loadu_ps(values);
+    size_t index{8};
+
+    for (; index + 8 <= count; index += 8)
+        result_values = _mm256_max_ps(result_values, _mm256_loadu_ps(values + index));
+
+    const auto half_values = _mm_max_ps(_mm256_castps256_ps128(result_values), _mm256_extractf128_ps(result_values, 1));
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, half_values);
+
+    auto result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+
+    for (; index < count; ++index)
+        result = std::max(result, values[index]);
+
+    return result;
+}
+
+CUI_SDK_SPECTRUM_AVX2_FUNCTION void falloff_avx2(
+    float* current, const float* target, size_t count, float falloff) noexcept
+{
+    const auto falloff_values = _mm256_set1_ps(falloff);
+    size_t index{};
+
+    for (; index + 8 <= count; index += 8) {
+        const auto decayed = _mm256_sub_ps(_mm256_loadu_ps(current + index), falloff_values);
+        _mm256_storeu_ps(current + index, _mm256_max_ps(_mm256_loadu_ps(target + index), decayed));
+    }
+
+    falloff_sse2(current + index, target + index, count - index, falloff);
+}
+
+CUI_SDK_SPECTRUM_AVX2_FUNCTION void butterflies_avx2(float* real, float* imaginary, size_t size, size_t half_size,
+    const float* twiddle_real, const float* twiddle_imaginary) noexcept
+{
+    if (half_size < 8) {
+        butterflies_sse2(real, imaginary, size, half_size, twiddle_real, twiddle_imaginary);
+        return;
+    }
+
+    for (size_t start{}; start < size; start += half_size * 2) {
+        for (size_t offset{}; offset < half_size; offset += 8) {
+            const auto top = start + offset;
+            const auto bottom = top + half_size;
+
+            const auto w_real = _mm256_loadu_ps(twiddle_real + offset);
+            const auto w_imaginary = _mm256_loadu_ps(twiddle_imaginary + offset);
+            const auto bottom_real = _mm256_loadu_ps(real + bottom);
+            const auto bottom_imaginary = _mm256_loadu_ps(imaginary + bottom);
+            const auto top_real = _mm256_loadu_ps(real + top);
+            const auto top_imaginary = _mm256_loadu_ps(imaginary + top);
+
+            const auto product_real
+                = _mm256_fmsub_ps(bottom_real, w_real, _mm256_mul_ps(bottom_imaginary, w_imaginary));
+            const auto product_imaginary
+                = _mm256_fmadd_ps(bottom_real, w_imaginary, _mm256_mul_ps(bottom_imaginary, w_real));
+
+            _mm256_storeu_ps(real + bottom, _mm256_sub_ps(top_real, product_real));
+            _mm256_storeu_ps(imaginary + bottom, _mm256_sub_ps(top_imaginary, product_imaginary));
+            _mm256_storeu_ps(real + top, _mm256_add_ps(top_real, product_real));
+            _mm256_storeu_ps(imaginary + top, _mm256_add_ps(top_imaginary, product_imaginary));
+        }
+    }
+}
+
+#endif
+
+struct kernels {
+    decltype(&multiply_scalar) multiply;
+    decltype(&magnitudes_scalar) magnitudes;
+    decltype(&maximum_scalar) maximum;
+    decltype(&falloff_scalar) falloff;
+    decltype(&butterflies_scalar) butterflies;
+};
+
+constexpr kernels scalar_kernels{
+    multiply_scalar, magnitudes_scalar, maximum_scalar, falloff_scalar, butterflies_scalar};
+
+#if CUI_SDK_SPECTRUM_X86
+constexpr kernels sse2_kernels{multiply_sse2, magnitudes_sse2, maximum_sse2, falloff_sse2, butterflies_sse2};
+constexpr kernels avx2_kernels{multiply_avx2, magnitudes_avx2, maximum_avx2, falloff_avx2, butterflies_avx2};
+#endif
+
+std::atomic<simd_level>& get_current_simd_level() noexcept
+{
+    static std::atomic<simd_level> level{get_supported_simd_level()};
+    return level;
+}
+
+const kernels& get_kernels() noexcept
+{
+    switch (get_current_simd_level().load(std::memory_order_relaxed)) {
+#if CUI_SDK_SPECTRUM_X86
+    case simd_level::avx2:
+        return avx2_kernels;
+    case simd_level::sse2:
+        return sse2_kernels;
+#endif
+    default:
+        return scalar_kernels;
+    }
+}
+
+} // namespace
+
+simd_level get_simd_level() noexcept
+{
+    return get_current_simd_level().load(std::memory_order_relaxed);
+}
+
+simd_level get_supported_simd_level() noexcept
+{
+    static const auto level = detect_simd_level();
+    return level;
+}
+
+simd_level set_simd_level(simd_level level) noexcept
+{
+    const auto new_level = std::min(level, get_supported_simd_level());
+    get_current_simd_level().store(new_level, std::memory_order_relaxed);
+    return new_level;
+}
+
+void create_hann_window(float* window, size_t size)
+{
+    if (size == 1) {
+        window[0] = 1.0f;
+        return;
+    }
+
+    for (size_t index{}; index < size; ++index)
+        window[index] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * pi * index / (size - 1)));
+}
+
+void apply_window(const float* input, const float* window, float* output, size_t count) noexcept
+{
+    get_kernels().multiply(input, window, output, count);
+}
+
+void calculate_magnitudes(const float* real, const float* imaginary, float* magnitudes, size_t count) noexcept
+{
+    get_kernels().magnitudes(real, imaginary, magnitudes, count);
+}
+
+std::vector<uint32_t> create_log_frequency_bucket_edges(
+    unsigned sample_rate, size_t fft_size, size_t bucket_count, float min_frequency, float max_frequency)
+{
+    if (bucket_count == 0 || sample_rate == 0 || fft_size == 0)
+        return std::vector<uint32_t>(bucket_count + 1);
+
+    const auto bin_count = fft_size / 2;
+    const auto nyquist_frequency = sample_rate / 2.0;
+    const auto bin_width = static_cast<double>(sample_rate) / static_cast<double>(fft_size);
+    const auto low = std::max(static_cast<double>(min_frequency), bin_width);
+    const auto high = std::clamp(static_cast<double>(max_frequency), low, nyquist_frequency);
+
+    std::vector<uint32_t> edges(bucket_count + 1);
+
+    for (size_t index{}; index <= bucket_count; ++index) {
+        const auto position = static_cast<double>(index) / static_cast<double>(bucket_count);
+        const auto frequency = low * std::pow(high / low, position);
+        const auto bin = std::clamp(std::llround(frequency / bin_width), 0LL, static_cast<long long>(bin_count));
+        edges[index] = static_cast<uint32_t>(bin);
+    }
+
+    // Make sure each bucket contains at least one bin, where possible
+    for (size_t index{1}; index <= bucket_count; ++index)
+        edges[index] = std::min(std::max(edges[index], edges[index - 1] + 1), static_cast<uint32_t>(bin_count));
+
+    return edges;
+}
+
+void bucket_magnitudes(
+    const float* magnitudes, size_t bin_count, const uint32_t* edges, float* buckets, size_t bucket_count) noexcept
+{
+    const auto& selected_kernels = get_kernels();
+
+    for (size_t index{}; index < bucket_count; ++index) {
+        const auto first_bin = std::min(static_cast<size_t>(edges[index]), bin_count);
+        const auto last_bin = std::min(static_cast<size_t>(edges[index + 1]), bin_count);
+
+        if (first_bin >= bin_count)
+            buckets[index] = 0.0f;
+        else if (last_bin <= first_bin)
+            buckets[index] = magnitudes[first_bin];
+        else
+            buckets[index] = selected_kernels.maximum(magnitudes + first_bin, last_bin - first_bin);
+    }
+}
+
+void apply_falloff(float* current, const float* target, size_t count, float falloff) noexcept
+{
+    get_kernels().falloff(current, target, count, falloff);
+}
+
+fft::fft(size_t size) : m_size(size)
+{
+    if (size < 2 || (size & (size - 1)) != 0)
+        throw std::invalid_argument("FFT size must be a power of two, and at least 2");
+
+    size_t bit_count{};
+    while ((size_t{1} << bit_count) < size)
+        ++bit_count;
+
+    m_bit_reversed_indices.resize(size);
+
+    for (size_t index{}; index < size; ++index) {
+        uint32_t reversed{};
+
+        for (size_t bit{}; bit < bit_count; ++bit)
+            reversed |= static_cast<uint32_t>((index >> bit) & 1) << (bit_count - 1 - bit);
+
+        m_bit_reversed_indices[index] = reversed;
+    }
+
+    m_twiddle_real.reserve(size - 1);
+    m_twiddle_imaginary.reserve(size - 1);
+
+    for (size_t half_size{1}; half_size < size; half_size *= 2) {
+        for (size_t offset{}; offset < half_size; ++offset) {
+            const auto angle = -pi * static_cast<double>(offset) / static_cast<double>(half_size);
+            m_twiddle_real.emplace_back(static_cast<float>(std::cos(angle)));
+            m_twiddle_imaginary.emplace_back(static_cast<float>(std::sin(angle)));
+        }
+    }
+}
+
+void fft::transform_real(float* real, float* imaginary) const noexcept
+{
+    std::fill_n(imaginary, m_size, 0.0f);
+    transform(real, imaginary);
+}
+
+void fft::transform(float* real, float* imaginary) const noexcept
+{
+    for (size_t index{}; index < m_size; ++index) {
+        const auto reversed_index = m_bit_reversed_indices[index];
+
+        if (index < reversed_index) {
+            std::swap(real[index], real[reversed_index]);
+            std::swap(imaginary[index], imaginary[reversed_index]);
+        }
+    }
+
+    const auto butterflies = get_kernels().butterflies;
+
+    for (size_t half_size{1}; half_size < m_size; half_size *= 2) {
+        // The twiddle factors for the stage with half_size start at half_size - 1
+        butterflies(real, imaginary, m_size, half_size, m_twiddle_real.data() + half_size - 1,
+            m_twiddle_imaginary.data() + half_size - 1);
+    }
+}
+
+} // namespace uie::spectrum
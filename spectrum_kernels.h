@@ -0,0 +1,160 @@
+#pragma once
+
+/**
+ * \file spectrum_kernels.h
+ * \brief Vectorised building blocks for spectrum visualisations
+ *
+ * This header and spectrum_kernels.cpp only depend on the standard library, so that they can be built and tested on
+ * other platforms.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace uie::spectrum {
+
+/** Instruction set used by the functions in this namespace. */
+enum class simd_level {
+    scalar,
+    sse2,
+    /** AVX2 and FMA. */
+    avx2,
+};
+
+/** Get the instruction set the functions in this namespace use on the current processor. */
+[[nodiscard]] simd_level get_simd_level() noexcept;
+
+/** Get the best instruction set supported by the current processor. */
+[[nodiscard]] simd_level get_supported_simd_level() noexcept;
+
+/**
+ * Limit the instruction set used by the functions in this namespace.
+ *
+ * This is intended for testing and benchmarking the different implementations.
+ *
+ * \param level  the instruction set to use; this is reduced to get_supported_simd_level() if higher
+ * \return       the instruction set now in use
+ */
+simd_level set_simd_level(simd_level level) noexcept;
+
+/**
+ * Fill an array with a Hann window.
+ *
+ * \param window  receives the window
+ * \param size    number of elements
+ */
+void create_hann_window(float* window, size_t size);
+
+/**
+ * Multiply samples by a window function.
+ *
+ * \param input   input samples
+ * \param window  window function, as created by create_hann_window()
+ * \param output  receives the windowed samples (may be the same as input)
+ * \param count   number of samples
+ */
+void apply_window(const float* input, const float* window, float* output, size_t count) noexcept;
+
+/**
+ * Calculate the magnitudes of complex values stored as separate real and imaginary arrays.
+ *
+ * \param real        real parts
+ * \param imaginary   imaginary parts
+ * \param magnitudes  receives the magnitudes
+ * \param count       number of values
+ */
+void calculate_magnitudes(const float* real, const float* imaginary, float* magnitudes, size_t count) noexcept;
+
+/**
+ * Calculate the edges of logarithmically spaced frequency buckets.
+ *
+ * \param sample_rate     sample rate of the audio
+ * \param fft_size        size of the FFT
+ * \param bucket_count    number of buckets
+ * \param min_frequency   lowest frequency, in Hz
+ * \param max_frequency   highest frequency, in Hz (clamped to the Nyquist frequency)
+ * \return                bucket_count + 1 bin indices; bucket i covers bins [edges[i], edges[i + 1]). All
+ *                        edges are zero if sample_rate, fft_size or bucket_count is zero.
+ */
+[[nodiscard]] std::vector<uint32_t> create_log_frequency_bucket_edges(
+    unsigned sample_rate, size_t fft_size, size_t bucket_count, float min_frequency, float max_frequency);
+
+/**
+ * Reduce spectrum bins to buckets, taking the maximum magnitude in each bucket.
+ *
+ * Each bucket contains at least one bin.
+ *
+ * \param magnitudes    magnitudes of the spectrum bins
+ * \param bin_count     number of bins
+ * \param edges         bucket edges, as returned by create_log_frequency_bucket_edges()
+ * \param buckets       receives the value of each bucket
+ * \param bucket_count  number of buckets
+ */
+void bucket_magnitudes(const float* magnitudes, size_t bin_count, const uint32_t* edges, float* buckets,
+    size_t bucket_count) noexcept;
+
+/**
+ * Apply falloff to displayed values, so that they decrease gradually.
+ *
+ * Each value is set to the larger of the new value and the current value minus falloff.
+ *
+ * \param current  displayed values, updated in place
+ * \param target   new values
+ * \param count    number of values
+ * \param falloff  maximum decrease
+ */
+void apply_falloff(float* current, const float* target, size_t count, float falloff) noexcept;
+
+/**
+ * \brief Radix-2 fast Fourier transform for real input.
+ *
+ * Twiddle factors and the bit-reversal permutation are calculated once, when the object is constructed.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * uie::spectrum::fft transform(1024);
+ * std::vector<float> window(1024), real(1024), imaginary(1024), magnitudes(512);
+ *
+ * uie::spectrum::create_hann_window(window.data(), window.size());
+ * uie::spectrum::apply_window(samples, window.data(), real.data(), real.size());
+ * transform.transform_real(real.data(), imaginary.data());
+ * uie::spectrum::calculate_magnitudes(real.data(), imaginary.data(), magnitudes.data(), magnitudes.size());
+ * \endcode
+ */
+class fft {
+public:
+    /**
+     * \param size  size of the transform; must be a power of two, and at least 2
+     * \throw std::invalid_argument if size is not valid
+     */
+    explicit fft(size_t size);
+
+    [[nodiscard]] size_t get_size() const noexcept { return m_size; }
+
+    /**
+     * Transform real samples in place.
+     *
+     * \param real       on input, the samples; on output, the real parts of the result
+     * \param imaginary  receives the imaginary parts of the result
+     */
+    void transform_real(float* real, float* imaginary) const noexcept;
+
+    /**
+     * Transform complex values in place.
+     *
+     * \param real       real parts, transformed in place
+     * \param imaginary  imaginary parts, transformed in place
+     */
+    void transform(float* real, float* imaginary) const noexcept;
+
+private:
+    size_t m_size{};
+    std::vector<uint32_t> m_bit_reversed_indices;
+
+    // Twiddle factors for each stage, stored consecutively (half_size values for a stage with half_size)
+    std::vector<float> m_twiddle_real;
+    std::vector<float> m_twiddle_imaginary;
+};
+
+} // namespace uie::spectrum
@@ -0,0 +1,141 @@
+// Compares callback_list with a vector of std::function objects held by std::shared_ptr, which is how subscribers
+// are commonly stored (and what lambda_callback_token-based subscriptions amount to).
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "callback_list.h"
+
+namespace {
+
+using cui::callback_list;
+
+class shared_function_list {
+public:
+    using function_t = std::function<void(uint32_t)>;
+    using subscription = std::shared_ptr<function_t>;
+
+    subscription subscribe(function_t function)
+    {
+        auto item = std::make_shared<function_t>(std::move(function));
+        m_items.emplace_back(item);
+        return item;
+    }
+
+    void unsubscribe(const subscription& item) { std::erase(m_items, item); }
+
+    void notify(uint32_t value)
+    {
+        // Copied, so that callbacks can unsubscribe
+        const auto items = m_items;
+
+        for (auto& item : items)
+            (*item)(value);
+    }
+
+private:
+    std::vector<subscription> m_items;
+};
+
+/** Order in which subscriptions are released, so that unsubscribing isn't always from one end of the list. */
+std::vector<size_t> get_release_order(size_t count)
+{
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t{});
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    return order;
+}
+
+void bm_callback_list_churn(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto release_order = get_release_order(count);
+    callback_list<uint32_t> list;
+    std::vector<callback_list<uint32_t>::subscription> subscriptions(count);
+    uint64_t total{};
+
+    for (auto _ : state) {
+        for (size_t index{}; index < count; ++index)
+            subscriptions[index] = list.subscribe([&total, index](uint32_t value) { total += value + index; });
+
+        list.notify(1);
+
+        for (const auto index : release_order)
+            subscriptions[index].reset();
+    }
+
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void bm_shared_function_churn(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto release_order = get_release_order(count);
+    shared_function_list list;
+    std::vector<shared_function_list::subscription> subscriptions(count);
+    uint64_t total{};
+
+    for (auto _ : state) {
+        for (size_t index{}; index < count; ++index)
+            subscriptions[index] = list.subscribe([&total, index](uint32_t value) { total += value + index; });
+
+        list.notify(1);
+
+        for (const auto index : release_order) {
+            list.unsubscribe(subscriptions[index]);
+            subscriptions[index].reset();
+        }
+    }
+
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void bm_callback_list_notify(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    callback_list<uint32_t> list;
+    std::vector<callback_list<uint32_t>::subscription> subscriptions;
+    uint64_t total{};
+
+    for (size_t index{}; index < count; ++index)
+        subscriptions.emplace_back(list.subscribe([&total, index](uint32_t value) { total += value + index; }));
+
+    for (auto _ : state)
+        list.notify(1);
+
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void bm_shared_function_notify(benchmark::State& state)
+{
+    const auto count = static_cast<size_t>(state.range(0));
+    shared_function_list list;
+    std::vector<shared_function_list::subscription> subscriptions;
+    uint64_t total{};
+
+    for (size_t index{}; index < count; ++index)
+        subscriptions.emplace_back(list.subscribe([&total, index](uint32_t value) { total += value + index; }));
+
+    for (auto _ : state)
+        list.notify(1);
+
+    benchmark::DoNotOptimize(total);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+BENCHMARK(bm_callback_list_churn)->ArgName("subscribers")->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(bm_shared_function_churn)->ArgName("subscribers")->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(bm_callback_list_notify)->ArgName("subscribers")->RangeMultiplier(4)->Range(4, 1024);
+BENCHMARK(bm_shared_function_notify)->ArgName("subscribers")->RangeMultiplier(4)->Range(4, 1024);
+
+} // namespace
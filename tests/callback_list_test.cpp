@@ -0,0 +1,249 @@
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "callback_list.h"
+
+namespace {
+
+using cui::callback_list;
+using cui::small_function;
+
+/** Records when it's destroyed, to check when captures are released. */
+struct destruction_flag {
+    explicit destruction_flag(bool& is_destroyed) : is_destroyed(&is_destroyed) {}
+    destruction_flag(destruction_flag&& other) noexcept : is_destroyed(std::exchange(other.is_destroyed, nullptr)) {}
+    destruction_flag(const destruction_flag&) = delete;
+    destruction_flag& operator=(const destruction_flag&) = delete;
+
+    ~destruction_flag()
+    {
+        if (is_destroyed)
+            *is_destroyed = true;
+    }
+
+    bool* is_destroyed;
+};
+
+TEST(small_function, calls_small_and_large_function_objects)
+{
+    int value{};
+    small_function<int(int)> small([&value](int argument) { return value += argument; });
+
+    std::array<int, 32> large_capture{};
+    large_capture[31] = 10;
+    small_function<int(int)> large([large_capture](int argument) { return large_capture[31] + argument; });
+
+    EXPECT_EQ(small(2), 2);
+    EXPECT_EQ(small(3), 5);
+    EXPECT_EQ(large(1), 11);
+
+    auto moved_small = std::move(small);
+    auto moved_large = std::move(large);
+
+    EXPECT_FALSE(small);
+    EXPECT_FALSE(large);
+    EXPECT_EQ(moved_small(1), 6);
+    EXPECT_EQ(moved_large(2), 12);
+}
+
+TEST(small_function, destroys_function_object_on_reset)
+{
+    bool is_destroyed{};
+    small_function<void()> function([flag = destruction_flag(is_destroyed)] {});
+
+    EXPECT_FALSE(is_destroyed);
+    function.reset();
+    EXPECT_TRUE(is_destroyed);
+    EXPECT_FALSE(function);
+}
+
+TEST(callback_list, notifies_in_subscription_order)
+{
+    callback_list<int> list;
+    std::vector<int> calls;
+
+    auto first = list.subscribe([&calls](int value) { calls.emplace_back(value); });
+    auto second = list.subscribe([&calls](int value) { calls.emplace_back(value * 10); });
+
+    list.notify(2);
+
+    EXPECT_EQ(calls, (std::vector<int>{2, 20}));
+}
+
+TEST(callback_list, reset_unsubscribes)
+{
+    callback_list<> list;
+    int count{};
+
+    auto first = list.subscribe([&count] { count += 1; });
+    auto second = list.subscribe([&count] { count += 10; });
+    auto third = list.subscribe([&count] { count += 100; });
+
+    second.reset();
+    list.notify();
+
+    EXPECT_EQ(count, 101);
+    EXPECT_FALSE(second.is_subscribed());
+    EXPECT_TRUE(first.is_subscribed());
+
+    first.reset();
+    third.reset();
+
+    EXPECT_TRUE(list.is_empty());
+}
+
+TEST(callback_list, self_reset_keeps_captures_alive_until_callback_returns)
+{
+    callback_list<> list;
+    callback_list<>::subscription subscription;
+    bool is_destroyed{};
+    bool was_alive_after_reset{};
+
+    subscription = list.subscribe([&, flag = destruction_flag(is_destroyed)] {
+        subscription.reset();
+        was_alive_after_reset = !is_destroyed && flag.is_destroyed == &is_destroyed;
+    });
+
+    list.notify();
+
+    EXPECT_TRUE(was_alive_after_reset);
+    EXPECT_TRUE(is_destroyed);
+    EXPECT_TRUE(list.is_empty());
+}
+
+TEST(callback_list, self_destruction_keeps_captures_alive_until_callback_returns)
+{
+    callback_list<> list;
+    std::optional<callback_list<>::subscription> subscription;
+    bool is_destroyed{};
+    bool was_alive_after_destruction{};
+
+    subscription = list.subscribe([&, flag = destruction_flag(is_destroyed)] {
+        subscription.reset();
+        was_alive_after_destruction = !is_destroyed && flag.is_destroyed == &is_destroyed;
+    });
+
+    list.notify();
+
+    EXPECT_TRUE(was_alive_after_destruction);
+    EXPECT_TRUE(is_destroyed);
+    EXPECT_TRUE(list.is_empty());
+}
+
+TEST(callback_list, self_resubscription_replaces_callback_after_it_returns)
+{
+    callback_list<> list;
+    callback_list<>::subscription subscription;
+    bool is_first_destroyed{};
+    bool was_first_alive{};
+    int second_count{};
+
+    subscription = list.subscribe([&, flag = destruction_flag(is_first_destroyed)] {
+        subscription = list.subscribe([&second_count] { ++second_count; });
+        was_first_alive = !is_first_destroyed && flag.is_destroyed == &is_first_destroyed;
+    });
+
+    list.notify();
+
+    EXPECT_TRUE(was_first_alive);
+    EXPECT_TRUE(is_first_destroyed);
+    EXPECT_EQ(second_count, 0);
+
+    list.notify();
+
+    EXPECT_EQ(second_count, 1);
+}
+
+TEST(callback_list, callback_can_unsubscribe_later_callbacks)
+{
+    callback_list<> list;
+    callback_list<>::subscription second;
+    int first_count{};
+    int second_count{};
+
+    auto first = list.subscribe([&] {
+        ++first_count;
+        second.reset();
+    });
+    second = list.subscribe([&second_count] { ++second_count; });
+
+    list.notify();
+
+    EXPECT_EQ(first_count, 1);
+    EXPECT_EQ(second_count, 0);
+}
+
+TEST(callback_list, callbacks_subscribed_during_notification_are_called_next_time)
+{
+    callback_list<> list;
+    std::vector<callback_list<>::subscription> added;
+    int added_count{};
+
+    auto subscription = list.subscribe([&] { added.emplace_back(list.subscribe([&added_count] { ++added_count; })); });
+
+    list.notify();
+    EXPECT_EQ(added_count, 0);
+
+    list.notify();
+    EXPECT_EQ(added_count, 1);
+}
+
+TEST(callback_list, moving_a_subscription_during_notification_keeps_it_subscribed)
+{
+    callback_list<> list;
+    std::optional<callback_list<>::subscription> original;
+    callback_list<>::subscription moved;
+    int count{};
+
+    original = list.subscribe([&] {
+        ++count;
+
+        if (original) {
+            moved = std::move(*original);
+            original.reset();
+        }
+    });
+
+    list.notify();
+    list.notify();
+
+    EXPECT_EQ(count, 2);
+    EXPECT_TRUE(moved.is_subscribed());
+}
+
+TEST(callback_list, nested_notification_does_not_call_running_callback)
+{
+    callback_list<int> list;
+    std::vector<int> calls;
+
+    auto first = list.subscribe([&](int depth) {
+        calls.emplace_back(depth);
+
+        if (depth == 0)
+            list.notify(1);
+    });
+    auto second = list.subscribe([&](int depth) { calls.emplace_back(10 + depth); });
+
+    list.notify(0);
+
+    EXPECT_EQ(calls, (std::vector<int>{0, 11, 10}));
+}
+
+TEST(callback_list, destroying_the_list_unsubscribes)
+{
+    callback_list<>::subscription subscription;
+
+    {
+        callback_list<> list;
+        subscription = list.subscribe([] {});
+        EXPECT_TRUE(subscription.is_subscribed());
+    }
+
+    EXPECT_FALSE(subscription.is_subscribed());
+}
+
+} // namespace
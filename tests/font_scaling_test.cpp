@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "font_scaling.h"
+
+namespace {
+
+using cui::fonts::scale_font_height;
+
+TEST(font_scaling, scales_positive_heights)
+{
+    EXPECT_EQ(scale_font_height(12, 96, 96), 12);
+    EXPECT_EQ(scale_font_height(12, 96, 120), 15);
+    EXPECT_EQ(scale_font_height(12, 96, 144), 18);
+    EXPECT_EQ(scale_font_height(12, 96, 192), 24);
+    EXPECT_EQ(scale_font_height(24, 192, 96), 12);
+    EXPECT_EQ(scale_font_height(15, 120, 144), 18);
+}
+
+TEST(font_scaling, scales_negative_heights)
+{
+    EXPECT_EQ(scale_font_height(-12, 96, 96), -12);
+    EXPECT_EQ(scale_font_height(-12, 96, 120), -15);
+    EXPECT_EQ(scale_font_height(-12, 96, 144), -18);
+    EXPECT_EQ(scale_font_height(-12, 96, 192), -24);
+    EXPECT_EQ(scale_font_height(-24, 192, 96), -12);
+    EXPECT_EQ(scale_font_height(-15, 120, 144), -18);
+}
+
+TEST(font_scaling, rounds_to_nearest)
+{
+    // 9 * 120 / 96 = 11.25
+    EXPECT_EQ(scale_font_height(9, 96, 120), 11);
+    EXPECT_EQ(scale_font_height(-9, 96, 120), -11);
+
+    // 13 * 96 / 144 = 8.67
+    EXPECT_EQ(scale_font_height(13, 144, 96), 9);
+    EXPECT_EQ(scale_font_height(-13, 144, 96), -9);
+
+    // 11 * 168 / 96 = 19.25
+    EXPECT_EQ(scale_font_height(11, 96, 168), 19);
+    EXPECT_EQ(scale_font_height(-11, 96, 168), -19);
+}
+
+TEST(font_scaling, rounds_halves_away_from_zero)
+{
+    // 11 * 144 / 96 = 16.5
+    EXPECT_EQ(scale_font_height(11, 96, 144), 17);
+    EXPECT_EQ(scale_font_height(-11, 96, 144), -17);
+
+    // 1 * 180 / 120 = 1.5
+    EXPECT_EQ(scale_font_height(1, 120, 180), 2);
+    EXPECT_EQ(scale_font_height(-1, 120, 180), -2);
+
+    // 3 * 96 / 192 = 1.5
+    EXPECT_EQ(scale_font_height(3, 192, 96), 2);
+    EXPECT_EQ(scale_font_height(-3, 192, 96), -2);
+}
+
+TEST(font_scaling, handles_zero_values)
+{
+    EXPECT_EQ(scale_font_height(0, 96, 144), 0);
+    EXPECT_EQ(scale_font_height(12, 0, 144), 12);
+    EXPECT_EQ(scale_font_height(-12, 0, 144), -12);
+    EXPECT_EQ(scale_font_height(12, 96, 0), 0);
+}
+
+TEST(font_scaling, does_not_overflow_large_heights)
+{
+    EXPECT_EQ(scale_font_height(1'000'000'000, 96, 192), 2'000'000'000);
+    EXPECT_EQ(scale_font_height(-1'000'000'000, 96, 192), -2'000'000'000);
+}
+
+static_assert(scale_font_height(-11, 96, 144) == -17);
+
+} // namespace
@@ -0,0 +1,219 @@
+// Compares the std::function and switch based message dispatch of container_window_v3 with message_map, using a mock
+// of the dispatch layer.
+
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "win32_stubs.h"
+
+#include "message_map.h"
+
+namespace {
+
+struct message {
+    UINT msg{};
+    WPARAM wp{};
+};
+
+using on_message_t = std::function<LRESULT(HWND wnd, UINT msg, WPARAM wp, LPARAM lp)>;
+using message_dispatcher_t = LRESULT (*)(void* context, HWND wnd, UINT msg, WPARAM wp, LPARAM lp);
+
+/** Mock of container_window_v3::on_message(), including the messages it handles itself. */
+class mock_container_window {
+public:
+    explicit mock_container_window(on_message_t on_message) : m_on_message(std::move(on_message)) {}
+
+    mock_container_window(message_dispatcher_t dispatcher, void* context)
+        : m_dispatcher(dispatcher)
+        , m_dispatcher_context(context)
+    {
+    }
+
+    [[gnu::noinline]] LRESULT on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp)
+    {
+        switch (msg) {
+        case WM_NCCREATE:
+            m_wnd = wnd;
+            break;
+        case WM_NCDESTROY:
+            m_wnd = nullptr;
+            break;
+        case WM_SETTINGCHANGE:
+            ++m_setting_change_count;
+            break;
+        case WM_WINDOWPOSCHANGED:
+            ++m_window_pos_changed_count;
+            break;
+        }
+
+        if (m_dispatcher)
+            return m_dispatcher(m_dispatcher_context, wnd, msg, wp, lp);
+
+        return m_on_message ? m_on_message(wnd, msg, wp, lp) : DefWindowProc(wnd, msg, wp, lp);
+    }
+
+private:
+    HWND m_wnd{};
+    uint64_t m_setting_change_count{};
+    uint64_t m_window_pos_changed_count{};
+    on_message_t m_on_message;
+    message_dispatcher_t m_dispatcher{};
+    void* m_dispatcher_context{};
+};
+
+class panel_handlers {
+public:
+    LRESULT on_create(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 1); }
+    LRESULT on_size(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 2); }
+    LRESULT on_paint(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 3); }
+    LRESULT on_erase_background(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 4); }
+    LRESULT on_set_cursor(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 5); }
+    LRESULT on_notify(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 6); }
+    LRESULT on_context_menu(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 7); }
+    LRESULT on_timer(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 8); }
+    LRESULT on_mouse_move(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 9); }
+    LRESULT on_mouse_button(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 10); }
+    LRESULT on_mouse_wheel(HWND, UINT, WPARAM wp, LPARAM) { return handle(wp, 11); }
+
+    [[nodiscard]] uint64_t get_total() const { return m_total; }
+
+private:
+    LRESULT handle(WPARAM wp, LRESULT result)
+    {
+        m_total += wp;
+        return result;
+    }
+
+    uint64_t m_total{};
+};
+
+/** A panel written the way container_uie_window_v3_t panels are, with a virtual on_message() containing a switch. */
+class switch_panel_base {
+public:
+    virtual ~switch_panel_base() = default;
+    virtual LRESULT on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp) = 0;
+};
+
+class switch_panel final
+    : public switch_panel_base
+    , public panel_handlers {
+public:
+    LRESULT on_message(HWND wnd, UINT msg, WPARAM wp, LPARAM lp) override
+    {
+        switch (msg) {
+        case WM_CREATE:
+            return on_create(wnd, msg, wp, lp);
+        case WM_SIZE:
+            return on_size(wnd, msg, wp, lp);
+        case WM_PAINT:
+            return on_paint(wnd, msg, wp, lp);
+        case WM_ERASEBKGND:
+            return on_erase_background(wnd, msg, wp, lp);
+        case WM_SETCURSOR:
+            return on_set_cursor(wnd, msg, wp, lp);
+        case WM_NOTIFY:
+            return on_notify(wnd, msg, wp, lp);
+        case WM_CONTEXTMENU:
+            return on_context_menu(wnd, msg, wp, lp);
+        case WM_TIMER:
+            return on_timer(wnd, msg, wp, lp);
+        case WM_MOUSEMOVE:
+            return on_mouse_move(wnd, msg, wp, lp);
+        case WM_LBUTTONDOWN:
+        case WM_LBUTTONUP:
+            return on_mouse_button(wnd, msg, wp, lp);
+        case WM_MOUSEWHEEL:
+            return on_mouse_wheel(wnd, msg, wp, lp);
+        }
+        return DefWindowProc(wnd, msg, wp, lp);
+    }
+};
+
+class message_map_panel final : public panel_handlers {
+public:
+    using map = uie::message_map<message_map_panel, uie::message_entry<WM_CREATE, &message_map_panel::on_create>,
+        uie::message_entry<WM_SIZE, &message_map_panel::on_size>,
+        uie::message_entry<WM_PAINT, &message_map_panel::on_paint>,
+        uie::message_entry<WM_ERASEBKGND, &message_map_panel::on_erase_background>,
+        uie::message_entry<WM_SETCURSOR, &message_map_panel::on_set_cursor>,
+        uie::message_entry<WM_NOTIFY, &message_map_panel::on_notify>,
+        uie::message_entry<WM_CONTEXTMENU, &message_map_panel::on_context_menu>,
+        uie::message_entry<WM_TIMER, &message_map_panel::on_timer>,
+        uie::message_entry<WM_MOUSEMOVE, &message_map_panel::on_mouse_move>,
+        uie::message_entry<WM_LBUTTONDOWN, &message_map_panel::on_mouse_button>,
+        uie::message_entry<WM_LBUTTONUP, &message_map_panel::on_mouse_button>,
+        uie::message_entry<WM_MOUSEWHEEL, &message_map_panel::on_mouse_wheel>>;
+};
+
+/** A synthetic message stream, weighted towards the messages a panel receives most often. */
+const std::vector<message>& get_messages()
+{
+    static const auto messages = [] {
+        constexpr std::pair<UINT, int> weighted_messages[] = {{WM_MOUSEMOVE, 30}, {WM_NCHITTEST, 20},
+            {WM_SETCURSOR, 20}, {WM_PAINT, 8}, {WM_ERASEBKGND, 8}, {WM_TIMER, 8}, {WM_NOTIFY, 6}, {WM_SIZE, 3},
+            {WM_WINDOWPOSCHANGED, 3}, {WM_LBUTTONDOWN, 1}, {WM_LBUTTONUP, 1}, {WM_MOUSEWHEEL, 1},
+            {WM_CONTEXTMENU, 1}};
+
+        std::vector<UINT> pool;
+        for (auto [msg, weight] : weighted_messages)
+            pool.insert(pool.end(), weight, msg);
+
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<size_t> distribution(0, pool.size() - 1);
+
+        std::vector<message> result(4096);
+        for (size_t index{}; index < result.size(); ++index)
+            result[index] = {pool[distribution(generator)], index & 0xff};
+
+        return result;
+    }();
+
+    return messages;
+}
+
+template <class Panel>
+void run(benchmark::State& state, mock_container_window& window, const Panel& panel)
+{
+    const auto& messages = get_messages();
+    const auto wnd = reinterpret_cast<HWND>(&window);
+
+    for (auto _ : state) {
+        LRESULT sum{};
+
+        for (auto& item : messages)
+            sum += window.on_message(wnd, item.msg, item.wp, 0);
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    benchmark::DoNotOptimize(panel.get_total());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(messages.size()));
+}
+
+void bm_switch_with_std_function(benchmark::State& state)
+{
+    // As container_uie_window_v3_t does, forward through a lambda to a virtual function
+    switch_panel panel;
+    switch_panel_base& base = panel;
+    mock_container_window window(
+        [&base](HWND wnd, UINT msg, WPARAM wp, LPARAM lp) { return base.on_message(wnd, msg, wp, lp); });
+
+    run(state, window, panel);
+}
+
+void bm_message_map(benchmark::State& state)
+{
+    message_map_panel panel;
+    mock_container_window window(&message_map_panel::map::s_dispatch, &panel);
+
+    run(state, window, panel);
+}
+
+BENCHMARK(bm_switch_with_std_function);
+BENCHMARK(bm_message_map);
+
+} // namespace
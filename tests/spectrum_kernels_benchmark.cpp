@@ -0,0 +1,140 @@
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "spectrum_kernels.h"
+
+namespace {
+
+using namespace uie::spectrum;
+
+constexpr size_t bucket_count = 64;
+
+std::vector<float> create_samples(size_t size)
+{
+    std::vector<float> samples(size);
+
+    for (size_t index{}; index < size; ++index)
+        samples[index] = static_cast<float>(std::sin(0.05 * static_cast<double>(index)));
+
+    return samples;
+}
+
+bool select_simd_level(benchmark::State& state)
+{
+    const auto level = static_cast<simd_level>(state.range(1));
+
+    if (level > get_supported_simd_level()) {
+        state.SkipWithError("Instruction set not supported by this processor");
+        return false;
+    }
+
+    set_simd_level(level);
+    return true;
+}
+
+void set_items_processed(benchmark::State& state, size_t items_per_iteration)
+{
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(items_per_iteration));
+}
+
+void bm_transform_real(benchmark::State& state)
+{
+    if (!select_simd_level(state))
+        return;
+
+    const auto size = static_cast<size_t>(state.range(0));
+    const fft transform(size);
+    const auto samples = create_samples(size);
+    std::vector<float> real(size), imaginary(size);
+
+    for (auto _ : state) {
+        real = samples;
+        transform.transform_real(real.data(), imaginary.data());
+        benchmark::DoNotOptimize(real.data());
+        benchmark::DoNotOptimize(imaginary.data());
+    }
+
+    set_items_processed(state, size);
+}
+
+void bm_calculate_magnitudes(benchmark::State& state)
+{
+    if (!select_simd_level(state))
+        return;
+
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto real = create_samples(size);
+    const auto imaginary = create_samples(size);
+    std::vector<float> magnitudes(size);
+
+    for (auto _ : state) {
+        calculate_magnitudes(real.data(), imaginary.data(), magnitudes.data(), size);
+        benchmark::DoNotOptimize(magnitudes.data());
+    }
+
+    set_items_processed(state, size);
+}
+
+void bm_bucket_magnitudes(benchmark::State& state)
+{
+    if (!select_simd_level(state))
+        return;
+
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto bin_count = size / 2;
+    const auto edges = create_log_frequency_bucket_edges(44100, size, bucket_count, 20.0f, 20000.0f);
+    const auto magnitudes = create_samples(bin_count);
+    std::vector<float> buckets(bucket_count);
+
+    for (auto _ : state) {
+        bucket_magnitudes(magnitudes.data(), bin_count, edges.data(), buckets.data(), bucket_count);
+        benchmark::DoNotOptimize(buckets.data());
+    }
+
+    set_items_processed(state, bin_count);
+}
+
+void bm_spectrum_frame(benchmark::State& state)
+{
+    if (!select_simd_level(state))
+        return;
+
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto bin_count = size / 2;
+    const fft transform(size);
+    const auto samples = create_samples(size);
+    const auto edges = create_log_frequency_bucket_edges(44100, size, bucket_count, 20.0f, 20000.0f);
+    std::vector<float> window(size), real(size), imaginary(size), magnitudes(bin_count);
+    std::vector<float> buckets(bucket_count), displayed(bucket_count);
+
+    create_hann_window(window.data(), size);
+
+    for (auto _ : state) {
+        apply_window(samples.data(), window.data(), real.data(), size);
+        transform.transform_real(real.data(), imaginary.data());
+        calculate_magnitudes(real.data(), imaginary.data(), magnitudes.data(), bin_count);
+        bucket_magnitudes(magnitudes.data(), bin_count, edges.data(), buckets.data(), bucket_count);
+        apply_falloff(displayed.data(), buckets.data(), bucket_count, 0.01f);
+        benchmark::DoNotOptimize(displayed.data());
+    }
+
+    set_items_processed(state, size);
+}
+
+void add_arguments(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgNames({"size", "simd_level"});
+
+    for (const auto level : {simd_level::scalar, simd_level::sse2, simd_level::avx2})
+        for (const int64_t size : {512, 1024, 2048, 4096, 8192})
+            benchmark->Args({size, static_cast<int64_t>(level)});
+}
+
+BENCHMARK(bm_transform_real)->Apply(add_arguments);
+BENCHMARK(bm_calculate_magnitudes)->Apply(add_arguments);
+BENCHMARK(bm_bucket_magnitudes)->Apply(add_arguments);
+BENCHMARK(bm_spectrum_frame)->Apply(add_arguments);
+
+} // namespace
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "spectrum_kernels.h"
+
+namespace {
+
+using namespace uie::spectrum;
+
+std::vector<std::complex<double>> calculate_reference_dft(const std::vector<std::complex<double>>& input)
+{
+    const auto size = input.size();
+    std::vector<std::complex<double>> output(size);
+
+    for (size_t bin{}; bin < size; ++bin) {
+        for (size_t index{}; index < size; ++index) {
+            const auto angle = -2.0 * std::numbers::pi * static_cast<double>((bin * index) % size)
+                / static_cast<double>(size);
+            output[bin] += input[index] * std::polar(1.0, angle);
+        }
+    }
+
+    return output;
+}
+
+std::vector<float> create_test_signal(size_t size, double frequency, double phase)
+{
+    std::vector<float> values(size);
+
+    for (size_t index{}; index < size; ++index)
+        values[index] = static_cast<float>(std::sin(frequency * static_cast<double>(index) + phase)
+            + 0.25 * std::cos(3.1 * frequency * static_cast<double>(index)));
+
+    return values;
+}
+
+class spectrum_kernels_test : public testing::TestWithParam<simd_level> {
+protected:
+    void SetUp() override
+    {
+        if (GetParam() > get_supported_simd_level())
+            GTEST_SKIP() << "Instruction set not supported by this processor";
+
+        ASSERT_EQ(set_simd_level(GetParam()), GetParam());
+    }
+
+    void TearDown() override { set_simd_level(get_supported_simd_level()); }
+};
+
+TEST_P(spectrum_kernels_test, transform_matches_reference_dft)
+{
+    for (size_t size{2}; size <= 4096; size *= 2) {
+        SCOPED_TRACE(size);
+
+        const auto input_real = create_test_signal(size, 0.37, 0.0);
+        const auto input_imaginary = create_test_signal(size, 1.1, 0.5);
+
+        std::vector<std::complex<double>> input(size);
+        for (size_t index{}; index < size; ++index)
+            input[index] = {input_real[index], input_imaginary[index]};
+
+        const auto expected = calculate_reference_dft(input);
+
+        auto real = input_real;
+        auto imaginary = input_imaginary;
+        const fft transform(size);
+        transform.transform(real.data(), imaginary.data());
+
+        // Single-precision rounding error grows with log2(size) and the magnitude of the values
+        const auto tolerance = 1e-5 * static_cast<double>(size) * std::log2(static_cast<double>(size) + 1.0);
+
+        for (size_t bin{}; bin < size; ++bin) {
+            ASSERT_NEAR(real[bin], expected[bin].real(), tolerance) << "bin " << bin;
+            ASSERT_NEAR(imaginary[bin], expected[bin].imag(), tolerance) << "bin " << bin;
+        }
+    }
+}
+
+TEST_P(spectrum_kernels_test, transform_real_ignores_imaginary_input)
+{
+    constexpr size_t size = 256;
+
+    auto real = create_test_signal(size, 0.2, 0.1);
+    std::vector<std::complex<double>> input(real.begin(), real.end());
+    const auto expected = calculate_reference_dft(input);
+
+    std::vector<float> imaginary(size, 123.0f);
+    fft(size).transform_real(real.data(), imaginary.data());
+
+    for (size_t bin{}; bin < size; ++bin) {
+        ASSERT_NEAR(real[bin], expected[bin].real(), 1e-3) << "bin " << bin;
+        ASSERT_NEAR(imaginary[bin], expected[bin].imag(), 1e-3) << "bin " << bin;
+    }
+}
+
+TEST_P(spectrum_kernels_test, apply_window_multiplies_elementwise)
+{
+    // Odd sizes exercise the scalar tails of the vectorised kernels
+    for (const size_t size : {1, 3, 7, 8, 17, 1000}) {
+        SCOPED_TRACE(size);
+
+        std::vector<float> window(size);
+        create_hann_window(window.data(), size);
+
+        const auto input = create_test_signal(size, 0.5, 0.0);
+        std::vector<float> output(size);
+        apply_window(input.data(), window.data(), output.data(), size);
+
+        for (size_t index{}; index < size; ++index)
+            ASSERT_FLOAT_EQ(output[index], input[index] * window[index]);
+
+        // In place
+        auto in_place = input;
+        apply_window(in_place.data(), window.data(), in_place.data(), size);
+        ASSERT_EQ(in_place, output);
+    }
+}
+
+TEST_P(spectrum_kernels_test, calculate_magnitudes_matches_hypot)
+{
+    for (const size_t size : {1, 5, 8, 13, 513}) {
+        SCOPED_TRACE(size);
+
+        const auto real = create_test_signal(size, 0.3, 0.0);
+        const auto imaginary = create_test_signal(size, 0.7, 1.0);
+        std::vector<float> magnitudes(size);
+        calculate_magnitudes(real.data(), imaginary.data(), magnitudes.data(), size);
+
+        for (size_t index{}; index < size; ++index)
+            ASSERT_NEAR(magnitudes[index], std::hypot(real[index], imaginary[index]), 1e-6);
+    }
+}
+
+TEST_P(spectrum_kernels_test, bucket_magnitudes_takes_maximum_of_each_bucket)
+{
+    constexpr size_t fft_size = 1024;
+    constexpr size_t bin_count = fft_size / 2;
+    constexpr size_t bucket_count = 32;
+
+    const auto edges = create_log_frequency_bucket_edges(44100, fft_size, bucket_count, 20.0f, 20000.0f);
+    ASSERT_EQ(edges.size(), bucket_count + 1);
+
+    std::vector<float> magnitudes(bin_count);
+    for (size_t index{}; index < bin_count; ++index)
+        magnitudes[index] = static_cast<float>((index * 37) % 101);
+
+    std::vector<float> buckets(bucket_count);
+    bucket_magnitudes(magnitudes.data(), bin_count, edges.data(), buckets.data(), bucket_count);
+
+    for (size_t bucket{}; bucket < bucket_count; ++bucket) {
+        const auto first_bin = edges[bucket];
+        const auto last_bin = std::min<size_t>(std::max(edges[bucket + 1], first_bin + 1), bin_count);
+        const auto expected = *std::max_element(magnitudes.begin() + first_bin, magnitudes.begin() + last_bin);
+
+        ASSERT_EQ(buckets[bucket], expected) << "bucket " << bucket;
+    }
+}
+
+TEST_P(spectrum_kernels_test, apply_falloff_decreases_gradually)
+{
+    constexpr size_t size = 37;
+
+    std::vector<float> current(size, 5.0f);
+    std::vector<float> target(size);
+    for (size_t index{}; index < size; ++index)
+        target[index] = static_cast<float>(index % 7);
+
+    apply_falloff(current.data(), target.data(), size, 1.0f);
+
+    for (size_t index{}; index < size; ++index)
+        ASSERT_EQ(current[index], std::max(target[index], 4.0f)) << "index " << index;
+}
+
+INSTANTIATE_TEST_SUITE_P(simd_levels, spectrum_kernels_test,
+    testing::Values(simd_level::scalar, simd_level::sse2, simd_level::avx2),
+    [](const testing::TestParamInfo<simd_level>& info) -> std::string {
+        switch (info.param) {
+        case simd_level::sse2:
+            return "sse2";
+        case simd_level::avx2:
+            return "avx2";
+        default:
+            return "scalar";
+        }
+    });
+
+TEST(spectrum_kernels, fft_rejects_invalid_sizes)
+{
+    for (const size_t size : {0, 1, 3, 6, 1000})
+        EXPECT_THROW(fft{size}, std::invalid_argument) << "size " << size;
+
+    EXPECT_EQ(fft(2).get_size(), 2u);
+}
+
+TEST(spectrum_kernels, create_hann_window_is_symmetric)
+{
+    std::vector<float> window(65);
+    create_hann_window(window.data(), window.size());
+
+    EXPECT_FLOAT_EQ(window.front(), 0.0f);
+    EXPECT_FLOAT_EQ(window[32], 1.0f);
+
+    for (size_t index{}; index < window.size(); ++index)
+        EXPECT_NEAR(window[index], window[window.size() - 1 - index], 1e-6f);
+
+    float single{};
+    create_hann_window(&single, 1);
+    EXPECT_EQ(single, 1.0f);
+}
+
+TEST(spectrum_kernels, bucket_edges_are_increasing_and_bounded)
+{
+    const auto edges = create_log_frequency_bucket_edges(48000, 2048, 64, 20.0f, 96000.0f);
+
+    ASSERT_EQ(edges.size(), 65u);
+
+    for (size_t index{1}; index < edges.size(); ++index) {
+        EXPECT_GT(edges[index], edges[index - 1]);
+        EXPECT_LE(edges[index], 1024u);
+    }
+}
+
+TEST(spectrum_kernels, bucket_edges_handle_zero_sizes)
+{
+    EXPECT_EQ(create_log_frequency_bucket_edges(44100, 1024, 0, 20.0f, 20000.0f), std::vector<uint32_t>(1));
+    EXPECT_EQ(create_log_frequency_bucket_edges(0, 1024, 4, 20.0f, 20000.0f), std::vector<uint32_t>(5));
+    EXPECT_EQ(create_log_frequency_bucket_edges(44100, 0, 4, 20.0f, 20000.0f), std::vector<uint32_t>(5));
+}
+
+TEST(spectrum_kernels, set_simd_level_is_limited_to_supported_level)
+{
+    const auto supported_level = get_supported_simd_level();
+
+    EXPECT_EQ(set_simd_level(simd_level::avx2), supported_level);
+    EXPECT_EQ(get_simd_level(), supported_level);
+    EXPECT_EQ(set_simd_level(simd_level::scalar), simd_level::scalar);
+    EXPECT_EQ(get_simd_level(), simd_level::scalar);
+
+    set_simd_level(supported_level);
+}
+
+} // namespace
@@ -0,0 +1,38 @@
+#pragma once
+
+// Minimal stand-ins for the Win32 types and functions used by message_map.h, so that window message dispatch can be
+// benchmarked on other platforms.
+
+#include <cstdint>
+
+struct HWND__;
+using HWND = HWND__*;
+using UINT = unsigned;
+using WPARAM = uintptr_t;
+using LPARAM = intptr_t;
+using LRESULT = intptr_t;
+
+constexpr UINT WM_CREATE = 0x0001;
+constexpr UINT WM_DESTROY = 0x0002;
+constexpr UINT WM_SIZE = 0x0005;
+constexpr UINT WM_PAINT = 0x000F;
+constexpr UINT WM_ERASEBKGND = 0x0014;
+constexpr UINT WM_SETTINGCHANGE = 0x001A;
+constexpr UINT WM_SETCURSOR = 0x0020;
+constexpr UINT WM_WINDOWPOSCHANGED = 0x0047;
+constexpr UINT WM_NOTIFY = 0x004E;
+constexpr UINT WM_CONTEXTMENU = 0x007B;
+constexpr UINT WM_NCCREATE = 0x0081;
+constexpr UINT WM_NCDESTROY = 0x0082;
+constexpr UINT WM_NCHITTEST = 0x0084;
+constexpr UINT WM_TIMER = 0x0113;
+constexpr UINT WM_MOUSEMOVE = 0x0200;
+constexpr UINT WM_LBUTTONDOWN = 0x0201;
+constexpr UINT WM_LBUTTONUP = 0x0202;
+constexpr UINT WM_MOUSEWHEEL = 0x020A;
+
+// Like the real function, this is an out-of-line call
+[[gnu::noinline]] inline LRESULT DefWindowProc(HWND, UINT msg, WPARAM wp, LPARAM)
+{
+    return static_cast<LRESULT>(msg) ^ static_cast<LRESULT>(wp);
+}
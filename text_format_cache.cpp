@@ -0,0 +1,144 @@
+#include "ui_extension.h"
+
+#if CUI_SDK_DWRITE_ENABLED
+
+namespace cui::fonts {
+
+text_format_cache& text_format_cache::s_get()
+{
+    static text_format_cache cache;
+    return cache;
+}
+
+text_format_cache::text_format_cache()
+{
+    if (manager_v3::ptr api; fb2k::std_api_try_get(api))
+        add_callback_token(api->on_default_font_fallback_changed(
+            fb2k::service_new<lambda_basic_callback>([] { s_get().invalidate(); })));
+}
+
+HRESULT text_format_cache::get_text_format(GUID font_id, IDWriteTextFormat** text_format, const wchar_t* locale_name,
+    const text_format_options& options) noexcept
+{
+    *text_format = nullptr;
+
+    const auto find_entry = [&] {
+        return std::ranges::find_if(m_entries, [&](const entry& item) {
+            return item.font_id == font_id && item.options == options && item.locale_name == locale_name;
+        });
+    };
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (const auto iter = find_entry(); iter != m_entries.end()) {
+            *text_format = iter->text_format.get_ptr();
+            (*text_format)->AddRef();
+            return S_OK;
+        }
+    }
+
+    manager_v3::ptr api;
+    if (!fb2k::std_api_try_get(api))
+        return E_NOINTERFACE;
+
+    pfc::com_ptr_t<IDWriteTextFormat> new_text_format;
+    if (const auto hr = s_create_text_format(api, font_id, locale_name, options, new_text_format.receive_ptr());
+        FAILED(hr))
+        return hr;
+
+    try {
+        register_callbacks(api, font_id);
+
+        std::scoped_lock lock(m_mutex);
+
+        if (const auto iter = find_entry(); iter != m_entries.end()) {
+            // Another thread got there first
+            new_text_format = iter->text_format;
+        } else if (!is_shut_down()) {
+            m_entries.push_back({font_id, locale_name, options, new_text_format});
+        }
+    } catch (const std::bad_alloc&) {
+        return E_OUTOFMEMORY;
+    } catch (const std::exception&) {
+        return E_FAIL;
+    }
+
+    *text_format = new_text_format.detach();
+    return S_OK;
+}
+
+void text_format_cache::invalidate()
+{
+    std::vector<entry> entries;
+
+    {
+        std::scoped_lock lock(m_mutex);
+        entries = std::move(m_entries);
+        m_entries.clear();
+    }
+}
+
+void text_format_cache::invalidate(GUID font_id)
+{
+    std::vector<entry> entries;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        for (auto& item : m_entries) {
+            if (item.font_id == font_id)
+                entries.emplace_back(std::move(item));
+        }
+
+        std::erase_if(m_entries, [font_id](const entry& item) { return item.font_id == font_id; });
+    }
+}
+
+HRESULT text_format_cache::s_create_text_format(const manager_v3::ptr& api, GUID font_id, const wchar_t* locale_name,
+    const text_format_options& options, IDWriteTextFormat** text_format) noexcept
+{
+    font::ptr font_ptr;
+
+    try {
+        font_ptr = api->get_font(font_id);
+    } catch (const exception_font_client_not_found&) {
+        return E_INVALIDARG;
+    } catch (const std::bad_alloc&) {
+        return E_OUTOFMEMORY;
+    }
+
+    pfc::com_ptr_t<IDWriteTextFormat> new_text_format;
+    HRESULT hr{};
+
+    if (FAILED(hr = font_ptr->create_text_format(new_text_format.receive_ptr(), locale_name)))
+        return hr;
+
+    if (FAILED(hr = new_text_format->SetTextAlignment(options.text_alignment)))
+        return hr;
+
+    if (FAILED(hr = new_text_format->SetParagraphAlignment(options.paragraph_alignment)))
+        return hr;
+
+    if (FAILED(hr = new_text_format->SetWordWrapping(options.word_wrapping)))
+        return hr;
+
+    if (FAILED(hr = new_text_format->SetReadingDirection(options.reading_direction)))
+        return hr;
+
+    *text_format = new_text_format.detach();
+    return S_OK;
+}
+
+void text_format_cache::register_callbacks(const manager_v3::ptr& api, GUID font_id)
+{
+    if (!claim_font_callbacks(font_id))
+        return;
+
+    add_callback_token(api->on_font_changed(
+        font_id, fb2k::service_new<lambda_basic_callback>([font_id] { s_get().invalidate(font_id); })));
+}
+
+} // namespace cui::fonts
+
+#endif
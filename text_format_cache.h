@@ -0,0 +1,102 @@
+#pragma once
+
+namespace cui::fonts {
+
+/**
+ * \brief Options applied to text formats created by text_format_cache.
+ */
+struct text_format_options {
+    DWRITE_TEXT_ALIGNMENT text_alignment{DWRITE_TEXT_ALIGNMENT_LEADING};
+    DWRITE_PARAGRAPH_ALIGNMENT paragraph_alignment{DWRITE_PARAGRAPH_ALIGNMENT_NEAR};
+    DWRITE_WORD_WRAPPING word_wrapping{DWRITE_WORD_WRAPPING_WRAP};
+    DWRITE_READING_DIRECTION reading_direction{DWRITE_READING_DIRECTION_LEFT_TO_RIGHT};
+
+    bool operator==(const text_format_options&) const = default;
+};
+
+/**
+ * \brief Shares DirectWrite text formats for Columns UI fonts between all windows in a module.
+ *
+ * Text formats are keyed by font ID, locale name and text format options. They are created using
+ * font::create_text_format() the first time they are requested, and are discarded when Columns UI reports that the
+ * font has changed (via manager_v3::on_font_changed()) or that the default font fallback has changed.
+ *
+ * \warning Text formats returned by this class are shared, and must not be modified. Pass the text alignment, word
+ * wrapping and other options needed using text_format_options instead.
+ *
+ * \note Requires Columns UI 3.0.0 or newer.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * cui::fonts::text_format_options options;
+ * options.word_wrapping = DWRITE_WORD_WRAPPING_NO_WRAP;
+ *
+ * m_text_format = cui::fonts::text_format_cache::s_get().get_wil_text_format(my_font_client_id, L"", options);
+ * \endcode
+ */
+class text_format_cache final : public shared_cache_base {
+public:
+    static text_format_cache& s_get();
+
+    /**
+     * Get a text format for a font.
+     *
+     * \param font_id       GUID of the font client or common font
+     * \param text_format   receives the text format, with a reference added
+     * \param locale_name   locale name passed to font::create_text_format()
+     * \param options       options to apply to the text format
+     * \return              HRESULT indicating success or failure code. `E_NOINTERFACE` is returned if a compatible
+     *                      version of Columns UI is not installed, and `E_INVALIDARG` if font_id is not valid.
+     */
+    [[nodiscard]] HRESULT get_text_format(GUID font_id, IDWriteTextFormat** text_format,
+        const wchar_t* locale_name = L"", const text_format_options& options = {}) noexcept;
+
+    /** Discard all text formats. */
+    void invalidate();
+
+    /**
+     * Discard text formats for a particular font.
+     *
+     * \param font_id  GUID of the font client or common font
+     */
+    void invalidate(GUID font_id);
+
+#ifdef __WIL_COM_INCLUDED
+    wil::com_ptr<IDWriteTextFormat> get_wil_text_format(
+        GUID font_id, const wchar_t* locale_name = L"", const text_format_options& options = {})
+    {
+        wil::com_ptr<IDWriteTextFormat> text_format;
+        THROW_IF_FAILED(get_text_format(font_id, &text_format, locale_name, options));
+        return text_format;
+    }
+
+    wil::com_ptr<IDWriteTextFormat> try_get_wil_text_format(
+        GUID font_id, const wchar_t* locale_name = L"", const text_format_options& options = {}) noexcept
+    {
+        wil::com_ptr<IDWriteTextFormat> text_format;
+        (void)get_text_format(font_id, &text_format, locale_name, options);
+        return text_format;
+    }
+#endif
+
+private:
+    struct entry {
+        GUID font_id{};
+        std::wstring locale_name;
+        text_format_options options;
+        pfc::com_ptr_t<IDWriteTextFormat> text_format;
+    };
+
+    text_format_cache();
+
+    static HRESULT s_create_text_format(const manager_v3::ptr& api, GUID font_id, const wchar_t* locale_name,
+        const text_format_options& options, IDWriteTextFormat** text_format) noexcept;
+
+    void on_shutdown() override { invalidate(); }
+    void register_callbacks(const manager_v3::ptr& api, GUID font_id);
+
+    std::mutex m_mutex;
+    std::vector<entry> m_entries;
+};
+
+} // namespace cui::fonts
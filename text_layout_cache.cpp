@@ -0,0 +1,172 @@
+#include "ui_extension.h"
+
+#if CUI_SDK_DWRITE_ENABLED
+
+namespace cui::fonts {
+
+namespace {
+
+// DirectWrite doesn't report the memory used by text layouts, so this is a rough estimate
+constexpr size_t estimated_layout_base_bytes = 1024;
+constexpr size_t estimated_layout_bytes_per_character = 64;
+
+} // namespace
+
+size_t text_layout_cache::key_hasher::operator()(const key& value) const noexcept
+{
+    auto hash = std::hash<std::wstring_view>()(value.text);
+
+    const auto combine = [&hash](size_t item_hash) {
+        hash ^= item_hash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    combine(std::hash<IDWriteTextFormat*>()(value.text_format));
+    combine(std::hash<float>()(value.max_width));
+    combine(std::hash<float>()(value.max_height));
+    combine(std::hash<float>()(value.pixels_per_dip));
+
+    return hash;
+}
+
+text_layout_cache::text_layout_cache(GUID font_id, size_t max_bytes) : m_font_id(font_id), m_max_bytes(max_bytes)
+{
+    manager_v3::ptr api;
+    if (!fb2k::std_api_try_get(api))
+        return;
+
+    try {
+        add_callback_token(
+            api->on_font_changed(font_id, fb2k::service_new<lambda_basic_callback>([this] { invalidate(); })));
+    } catch (const exception_font_client_not_found&) {
+    }
+
+    add_callback_token(api->on_default_rendering_options_changed(
+        fb2k::service_new<lambda_basic_callback>([this] { invalidate(); })));
+}
+
+text_layout_cache::~text_layout_cache()
+{
+    // The callbacks use this instance, so they're released before its members are destroyed
+    shutdown();
+}
+
+HRESULT text_layout_cache::get_text_layout(IDWriteFactory* factory, IDWriteTextFormat* text_format,
+    std::wstring_view text, float max_width, float max_height, float pixels_per_dip, IDWriteTextLayout** text_layout,
+    DWRITE_TEXT_METRICS* metrics) noexcept
+{
+    *text_layout = nullptr;
+
+    if (text.size() > std::numeric_limits<UINT32>::max())
+        return E_INVALIDARG;
+
+    try {
+        const key lookup_key{text, text_format, max_width, max_height, pixels_per_dip};
+
+        if (const auto iter = m_index.find(lookup_key); iter != m_index.end()) {
+            ++m_stats.hits;
+            m_entries.splice(m_entries.begin(), m_entries, iter->second);
+        } else {
+            ++m_stats.misses;
+
+            pfc::com_ptr_t<IDWriteTextLayout> new_text_layout;
+            HRESULT hr{};
+
+            if (FAILED(hr = create_text_layout(factory, text_format, text, max_width, max_height, pixels_per_dip,
+                           new_text_layout.receive_ptr())))
+                return hr;
+
+            DWRITE_TEXT_METRICS new_metrics{};
+            if (FAILED(hr = new_text_layout->GetMetrics(&new_metrics)))
+                return hr;
+
+            const auto estimated_bytes = sizeof(entry) + text.size() * sizeof(wchar_t) + estimated_layout_base_bytes
+                + text.size() * estimated_layout_bytes_per_character;
+
+            auto& new_entry = m_entries.emplace_front();
+            new_entry.text = text;
+            new_entry.text_format = text_format;
+            new_entry.max_width = max_width;
+            new_entry.max_height = max_height;
+            new_entry.pixels_per_dip = pixels_per_dip;
+            new_entry.text_layout = std::move(new_text_layout);
+            new_entry.metrics = new_metrics;
+            new_entry.estimated_bytes = estimated_bytes;
+
+            m_index.emplace(new_entry.get_key(), m_entries.begin());
+            m_estimated_bytes += estimated_bytes;
+
+            evict();
+        }
+    } catch (const std::bad_alloc&) {
+        return E_OUTOFMEMORY;
+    }
+
+    const auto& current_entry = m_entries.front();
+
+    *text_layout = current_entry.text_layout.get_ptr();
+    (*text_layout)->AddRef();
+
+    if (metrics)
+        *metrics = current_entry.metrics;
+
+    return S_OK;
+}
+
+void text_layout_cache::invalidate() noexcept
+{
+    m_index.clear();
+    m_entries.clear();
+    m_estimated_bytes = 0;
+    m_use_gdi_compatible_layout.reset();
+    ++m_stats.invalidations;
+}
+
+text_layout_cache_stats text_layout_cache::get_stats() const
+{
+    auto stats = m_stats;
+    stats.entry_count = m_entries.size();
+    stats.estimated_bytes = m_estimated_bytes;
+    return stats;
+}
+
+HRESULT text_layout_cache::create_text_layout(IDWriteFactory* factory, IDWriteTextFormat* text_format,
+    std::wstring_view text, float max_width, float max_height, float pixels_per_dip, IDWriteTextLayout** text_layout)
+{
+    if (!m_use_gdi_compatible_layout) {
+        m_use_gdi_compatible_layout = false;
+
+        if (manager_v3::ptr api; fb2k::std_api_try_get(api)) {
+            try {
+                const auto rendering_options = api->get_font(m_font_id)->rendering_options();
+                m_use_gdi_compatible_layout = rendering_options->use_gdi_compatible_layout();
+                m_use_gdi_natural = rendering_options->use_gdi_natural();
+            } catch (const exception_font_client_not_found&) {
+            }
+        }
+    }
+
+    const auto text_length = static_cast<UINT32>(text.size());
+
+    if (*m_use_gdi_compatible_layout)
+        return factory->CreateGdiCompatibleTextLayout(text.data(), text_length, text_format, max_width, max_height,
+            pixels_per_dip, nullptr, m_use_gdi_natural, text_layout);
+
+    return factory->CreateTextLayout(text.data(), text_length, text_format, max_width, max_height, text_layout);
+}
+
+void text_layout_cache::evict()
+{
+    // The most recently added entry is always kept, even if it's larger than the limit
+    while (m_estimated_bytes > m_max_bytes && m_entries.size() > 1) {
+        const auto& oldest_entry = m_entries.back();
+
+        m_index.erase(oldest_entry.get_key());
+        m_estimated_bytes -= oldest_entry.estimated_bytes;
+        m_entries.pop_back();
+        ++m_stats.evictions;
+    }
+}
+
+} // namespace cui::fonts
+
+#endif
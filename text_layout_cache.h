@@ -0,0 +1,132 @@
+#pragma once
+
+namespace cui::fonts {
+
+/** \brief Counters for a text_layout_cache. */
+struct text_layout_cache_stats {
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+    uint64_t invalidations{};
+    size_t entry_count{};
+    size_t estimated_bytes{};
+
+    /** Get the proportion of lookups that were hits, between 0 and 1. */
+    [[nodiscard]] double hit_rate() const
+    {
+        const auto lookups = hits + misses;
+        return lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+/**
+ * \brief Caches DirectWrite text layouts for strings that are rendered repeatedly using a Columns UI font.
+ *
+ * Text layouts are keyed by the text, the text format, the maximum width and height, and the number of pixels per
+ * DIP. Text formats are compared by identity, so this works best with text formats from text_format_cache.
+ *
+ * Least recently used text layouts are evicted when the estimated memory used by the cache exceeds the limit passed
+ * to the constructor. (DirectWrite does not report how much memory a text layout uses, so the estimate is based on
+ * the length of the text.)
+ *
+ * The cache is emptied when Columns UI reports that the font or the default rendering options have changed (via
+ * manager_v3::on_font_changed() and manager_v3::on_default_rendering_options_changed()).
+ *
+ * If font::rendering_options() indicates that a GDI-compatible layout should be used,
+ * `IDWriteFactory::CreateGdiCompatibleTextLayout()` is used to create text layouts.
+ *
+ * \warning Text layouts returned by this class are shared, and must not be modified.
+ *
+ * \note This class is not thread-safe.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * wil::com_ptr<IDWriteTextLayout> text_layout;
+ * DWRITE_TEXT_METRICS metrics{};
+ *
+ * if (SUCCEEDED(m_text_layout_cache.get_text_layout(factory, text_format, L"3:42", max_width, max_height,
+ *         pixels_per_dip, &text_layout, &metrics)))
+ *     render_target->DrawTextLayout(origin, text_layout.get(), brush);
+ * \endcode
+ */
+class text_layout_cache : public shared_cache_base {
+public:
+    static constexpr size_t default_max_bytes = 4 * 1024 * 1024;
+
+    /**
+     * \param font_id    GUID of the font client or common font the text formats used with this cache are for
+     * \param max_bytes  approximate maximum amount of memory to use
+     */
+    explicit text_layout_cache(GUID font_id, size_t max_bytes = default_max_bytes);
+    ~text_layout_cache() override;
+
+    /**
+     * Get a text layout.
+     *
+     * \param factory         DirectWrite factory used to create the text layout if needed
+     * \param text_format     text format for the text
+     * \param text            the text
+     * \param max_width       maximum width of the layout box, in DIPs
+     * \param max_height      maximum height of the layout box, in DIPs
+     * \param pixels_per_dip  number of physical pixels per DIP
+     * \param text_layout     receives the text layout, with a reference added
+     * \param metrics         optionally receives the metrics of the text layout
+     * \return                HRESULT indicating success or failure code
+     */
+    [[nodiscard]] HRESULT get_text_layout(IDWriteFactory* factory, IDWriteTextFormat* text_format,
+        std::wstring_view text, float max_width, float max_height, float pixels_per_dip,
+        IDWriteTextLayout** text_layout, DWRITE_TEXT_METRICS* metrics = nullptr) noexcept;
+
+    /** Discard all text layouts. */
+    void invalidate() noexcept;
+
+    /** Get hit, miss and eviction counters, and the current size of the cache. */
+    [[nodiscard]] text_layout_cache_stats get_stats() const;
+
+private:
+    struct key {
+        std::wstring_view text;
+        IDWriteTextFormat* text_format{};
+        float max_width{};
+        float max_height{};
+        float pixels_per_dip{};
+
+        bool operator==(const key& other) const = default;
+    };
+
+    struct key_hasher {
+        size_t operator()(const key& value) const noexcept;
+    };
+
+    struct entry {
+        std::wstring text;
+        pfc::com_ptr_t<IDWriteTextFormat> text_format;
+        float max_width{};
+        float max_height{};
+        float pixels_per_dip{};
+        pfc::com_ptr_t<IDWriteTextLayout> text_layout;
+        DWRITE_TEXT_METRICS metrics{};
+        size_t estimated_bytes{};
+
+        [[nodiscard]] key get_key() const
+        {
+            return {text, text_format.get_ptr(), max_width, max_height, pixels_per_dip};
+        }
+    };
+
+    void on_shutdown() override { invalidate(); }
+    HRESULT create_text_layout(IDWriteFactory* factory, IDWriteTextFormat* text_format, std::wstring_view text,
+        float max_width, float max_height, float pixels_per_dip, IDWriteTextLayout** text_layout);
+    void evict();
+
+    const GUID m_font_id;
+    const size_t m_max_bytes;
+    std::list<entry> m_entries;
+    std::unordered_map<key, std::list<entry>::iterator, key_hasher> m_index;
+    std::optional<bool> m_use_gdi_compatible_layout;
+    bool m_use_gdi_natural{};
+    size_t m_estimated_bytes{};
+    text_layout_cache_stats m_stats;
+};
+
+} // namespace cui::fonts
@@ -0,0 +1,273 @@
+#include "ui_extension.h"
+
+#include <psapi.h>
+
+namespace uie::tracing {
+
+const GUID trace_sink::class_guid{0x4e0c2b7a, 0x93d1, 0x4f6e, {0x8b, 0x25, 0x1a, 0x7c, 0x6d, 0x3e, 0x9f, 0x40}};
+
+namespace {
+
+int64_t get_private_bytes()
+{
+    PROCESS_MEMORY_COUNTERS_EX counters{};
+    counters.cb = sizeof(counters);
+
+    if (!GetProcessMemoryInfo(
+            GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+        return 0;
+
+    return static_cast<int64_t>(counters.PrivateUsage);
+}
+
+void append_json_string(pfc::string_base& out, const char* value)
+{
+    out << "\"";
+
+    for (auto ptr = value; *ptr; ++ptr) {
+        const auto chr = static_cast<unsigned char>(*ptr);
+
+        if (chr == '"' || chr == '\\') {
+            out.add_byte('\\');
+            out.add_byte(*ptr);
+        } else if (chr < 0x20) {
+            out << "\\u00" << pfc::format_hex(chr, 2);
+        } else {
+            out.add_byte(*ptr);
+        }
+    }
+
+    out << "\"";
+}
+
+} // namespace
+
+const char* get_operation_type_name(operation_type type)
+{
+    switch (type) {
+    case operation_type::set_config:
+        return "set_config";
+    case operation_type::create_or_transfer_window:
+        return "create_or_transfer_window";
+    case operation_type::get_config:
+        return "get_config";
+    case operation_type::destroy_window:
+        return "destroy_window";
+    default:
+        return "unknown";
+    }
+}
+
+session& session::s_get()
+{
+    static session instance;
+    return instance;
+}
+
+void session::set_enabled(bool enabled)
+{
+    std::scoped_lock lock(m_mutex);
+
+    if (enabled) {
+        m_events.clear();
+        m_start_us.store(s_get_steady_clock_us(), std::memory_order_relaxed);
+    }
+
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void session::clear()
+{
+    std::scoped_lock lock(m_mutex);
+    m_events.clear();
+}
+
+void session::add_event(const event& event)
+{
+    std::scoped_lock lock(m_mutex);
+    m_events.emplace_back(event);
+}
+
+bool session::has_panel_name(const GUID& panel_id) const
+{
+    std::scoped_lock lock(m_mutex);
+    return std::ranges::find(m_panel_names, panel_id, &std::pair<GUID, pfc::string8>::first) != m_panel_names.end();
+}
+
+void session::set_panel_name(const GUID& panel_id, const char* name)
+{
+    std::scoped_lock lock(m_mutex);
+
+    const auto iter = std::ranges::find(m_panel_names, panel_id, &std::pair<GUID, pfc::string8>::first);
+
+    if (iter != m_panel_names.end())
+        iter->second = name;
+    else
+        m_panel_names.emplace_back(panel_id, name);
+}
+
+pfc::string8 session::get_panel_name(const GUID& panel_id) const
+{
+    std::scoped_lock lock(m_mutex);
+
+    const auto iter = std::ranges::find(m_panel_names, panel_id, &std::pair<GUID, pfc::string8>::first);
+
+    if (iter != m_panel_names.end())
+        return iter->second;
+
+    return pfc::print_guid(panel_id);
+}
+
+std::vector<event> session::get_events() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_events;
+}
+
+std::vector<panel_summary> session::get_panel_summaries() const
+{
+    std::vector<panel_summary> summaries;
+
+    for (auto&& event : get_events()) {
+        auto summary = std::ranges::find_if(
+            summaries, [&event](auto&& summary) { return summary.panel_id == event.panel_id; });
+
+        if (summary == summaries.end()) {
+            summaries.emplace_back(panel_summary{event.panel_id});
+            summary = std::prev(summaries.end());
+        }
+
+        ++summary->event_count;
+        summary->total_duration_us += event.duration_us;
+        summary->max_duration_us = std::max(summary->max_duration_us, event.duration_us);
+        summary->total_private_bytes_delta += event.private_bytes_delta;
+        summary->total_gdi_objects_delta += event.gdi_objects_delta;
+        summary->total_user_objects_delta += event.user_objects_delta;
+    }
+
+    std::ranges::sort(summaries, std::greater{}, &panel_summary::total_duration_us);
+    return summaries;
+}
+
+void session::write_summary_to_console() const
+{
+    for (auto&& summary : get_panel_summaries()) {
+        console::formatter formatter;
+        formatter << "Panel trace: " << get_panel_name(summary.panel_id) << " – "
+                  << pfc::format_uint(summary.event_count) << " operations, "
+                  << pfc::format_float(summary.total_duration_us / 1000.0, 0, 3) << " ms total, "
+                  << pfc::format_float(summary.max_duration_us / 1000.0, 0, 3) << " ms max, "
+                  << pfc::format_int(summary.total_private_bytes_delta) << " bytes, "
+                  << pfc::format_int(summary.total_gdi_objects_delta) << " GDI objects, "
+                  << pfc::format_int(summary.total_user_objects_delta) << " USER objects";
+    }
+}
+
+void session::write_chrome_trace(const char* path) const
+{
+    const auto events = get_events();
+    const auto process_id = GetCurrentProcessId();
+
+    std::vector<std::pair<GUID, pfc::string8>> panel_names;
+    for (auto&& summary : get_panel_summaries())
+        panel_names.emplace_back(summary.panel_id, get_panel_name(summary.panel_id));
+
+    pfc::string8 json;
+    json << "{\"traceEvents\":[";
+
+    for (auto&& event : events) {
+        const auto name_iter = std::ranges::find(panel_names, event.panel_id, &std::pair<GUID, pfc::string8>::first);
+        const char* name = name_iter != panel_names.end() ? name_iter->second.get_ptr() : "";
+
+        if (&event != &events.front())
+            json << ",";
+
+        json << "{\"name\":";
+        append_json_string(json, name);
+        json << ",\"cat\":\"" << get_operation_type_name(event.type) << "\",\"ph\":\"X\"";
+        json << ",\"ts\":" << pfc::format_int(event.start_us) << ",\"dur\":" << pfc::format_int(event.duration_us);
+        json << ",\"pid\":" << pfc::format_uint(process_id) << ",\"tid\":" << pfc::format_uint(event.thread_id);
+        json << ",\"args\":{\"panel_id\":\"" << pfc::print_guid(event.panel_id) << "\"";
+        json << ",\"private_bytes_delta\":" << pfc::format_int(event.private_bytes_delta);
+        json << ",\"gdi_objects_delta\":" << pfc::format_int(event.gdi_objects_delta);
+        json << ",\"user_objects_delta\":" << pfc::format_int(event.user_objects_delta) << "}}";
+    }
+
+    json << "]}";
+
+    file::ptr file;
+    filesystem::g_open_write_new(file, path, fb2k::noAbort);
+    file->write(json.get_ptr(), json.get_length(), fb2k::noAbort);
+}
+
+int64_t session::get_elapsed_us() const
+{
+    return s_get_steady_clock_us() - m_start_us.load(std::memory_order_relaxed);
+}
+
+trace_sink& get_trace_sink()
+{
+    // The reference is deliberately never released, as the module implementing the sink may be unloaded first
+    static const auto sink = [] {
+        trace_sink::ptr api;
+
+        if (!fb2k::std_api_try_get(api))
+            api = fb2k::service_new<session_trace_sink>();
+
+        return api.detach();
+    }();
+
+    return *sink;
+}
+
+scoped_trace::scoped_trace(const GUID& panel_id, operation_type type)
+{
+    if (get_trace_sink().is_enabled())
+        start(panel_id, type);
+}
+
+scoped_trace::scoped_trace(const extension_base& panel, operation_type type)
+{
+    auto& sink = get_trace_sink();
+
+    if (!sink.is_enabled())
+        return;
+
+    const auto& panel_id = panel.get_extension_guid();
+
+    if (!sink.has_panel_name(panel_id)) {
+        pfc::string8 name;
+        panel.get_name(name);
+        sink.set_panel_name(panel_id, name);
+    }
+
+    start(panel_id, type);
+}
+
+void scoped_trace::start(const GUID& panel_id, operation_type type)
+{
+    m_start_private_bytes = get_private_bytes();
+    m_start_gdi_objects = static_cast<int32_t>(GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS));
+    m_start_user_objects = static_cast<int32_t>(GetGuiResources(GetCurrentProcess(), GR_USEROBJECTS));
+    m_event = event{panel_id, type, get_trace_sink().get_elapsed_us()};
+}
+
+scoped_trace::~scoped_trace()
+{
+    if (!m_event)
+        return;
+
+    auto& sink = get_trace_sink();
+
+    m_event->duration_us = sink.get_elapsed_us() - m_event->start_us;
+    m_event->private_bytes_delta = get_private_bytes() - m_start_private_bytes;
+    m_event->gdi_objects_delta
+        = static_cast<int32_t>(GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS)) - m_start_gdi_objects;
+    m_event->user_objects_delta
+        = static_cast<int32_t>(GetGuiResources(GetCurrentProcess(), GR_USEROBJECTS)) - m_start_user_objects;
+    m_event->thread_id = GetCurrentThreadId();
+
+    sink.add_event(*m_event);
+}
+
+} // namespace uie::tracing
@@ -0,0 +1,220 @@
+#pragma once
+
+/**
+ * \file tracing.h
+ * \brief Timing instrumentation for panel and toolbar instantiation
+ */
+
+namespace uie::tracing {
+
+/**
+ * \brief Identifies the operation being traced.
+ */
+enum class operation_type {
+    set_config,
+    create_or_transfer_window,
+    get_config,
+    destroy_window,
+};
+
+/**
+ * \brief A completed traced operation.
+ */
+struct event {
+    GUID panel_id{};
+    operation_type type{};
+    /** Time the operation started, in microseconds since the trace session was enabled. */
+    int64_t start_us{};
+    /** Duration of the operation in microseconds. */
+    int64_t duration_us{};
+    /** Change in the private memory usage of the process during the operation, in bytes. */
+    int64_t private_bytes_delta{};
+    /** Change in the number of GDI objects used by the process during the operation. */
+    int32_t gdi_objects_delta{};
+    /** Change in the number of USER objects used by the process during the operation. */
+    int32_t user_objects_delta{};
+    DWORD thread_id{};
+};
+
+/**
+ * \brief Totals of traced operations for a single panel GUID.
+ */
+struct panel_summary {
+    GUID panel_id{};
+    size_t event_count{};
+    int64_t total_duration_us{};
+    int64_t max_duration_us{};
+    int64_t total_private_bytes_delta{};
+    int32_t total_gdi_objects_delta{};
+    int32_t total_user_objects_delta{};
+};
+
+/**
+ * \brief Collects traced operations.
+ *
+ * Each module has its own session. To collect operations from panels in all modules, the host enabling tracing
+ * registers session_trace_sink, so that scoped_trace in other modules sends its events to the host's session.
+ *
+ * Tracing is disabled by default. While disabled, scoped_trace does nothing apart from checking whether tracing
+ * is enabled.
+ */
+class session {
+public:
+    /** Get the trace session for this module. */
+    static session& s_get();
+
+    /** Enable or disable tracing. Enabling tracing clears any existing events. */
+    void set_enabled(bool enabled);
+
+    [[nodiscard]] bool is_enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    void clear();
+    void add_event(const event& event);
+
+    [[nodiscard]] std::vector<event> get_events() const;
+
+    [[nodiscard]] bool has_panel_name(const GUID& panel_id) const;
+
+    /**
+     * Set the name shown for a panel GUID in summaries and traces.
+     *
+     * This is called by scoped_trace when it's given a panel instance, so that panels don't need to be instantiated
+     * to get their names.
+     */
+    void set_panel_name(const GUID& panel_id, const char* name);
+
+    /** Get the name recorded for a panel GUID, or the GUID as a string if no name has been recorded. */
+    [[nodiscard]] pfc::string8 get_panel_name(const GUID& panel_id) const;
+
+    /** Get totals for each panel GUID, sorted by descending total duration. */
+    [[nodiscard]] std::vector<panel_summary> get_panel_summaries() const;
+
+    /** Write a summary of traced operations for each panel to the foobar2000 console. */
+    void write_summary_to_console() const;
+
+    /**
+     * Write traced operations to a JSON file in Chrome trace event format.
+     *
+     * The file can be opened in `chrome://tracing` or Perfetto.
+     *
+     * \param path  path of the file (UTF-8)
+     * \throw Throws pfc::exception on failure
+     */
+    void write_chrome_trace(const char* path) const;
+
+    /** Get the time elapsed since tracing was last enabled, in microseconds. */
+    [[nodiscard]] int64_t get_elapsed_us() const;
+
+private:
+    static int64_t s_get_steady_clock_us()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<event> m_events;
+    std::vector<std::pair<GUID, pfc::string8>> m_panel_names;
+    std::atomic<bool> m_enabled{};
+    // Stored as a tick count so that it can be read without holding m_mutex
+    std::atomic<int64_t> m_start_us{s_get_steady_clock_us()};
+};
+
+/**
+ * \brief Receives traced operations from all modules in the process.
+ *
+ * One implementation, registered by the host that collects traces (using session_trace_sink). scoped_trace sends
+ * events to it, so that operations on panels in other modules are included in the host's session.
+ *
+ * \see get_trace_sink()
+ */
+class NOVTABLE trace_sink : public service_base {
+public:
+    /** Get whether tracing is enabled. This is called at the start of every traced operation. */
+    [[nodiscard]] virtual bool is_enabled() const = 0;
+
+    /** Get the time elapsed since tracing was last enabled, in microseconds. */
+    [[nodiscard]] virtual int64_t get_elapsed_us() const = 0;
+
+    virtual void add_event(const event& event) = 0;
+    [[nodiscard]] virtual bool has_panel_name(const GUID& panel_id) const = 0;
+    virtual void set_panel_name(const GUID& panel_id, const char* name) = 0;
+
+    FB2K_MAKE_SERVICE_INTERFACE_ENTRYPOINT(trace_sink);
+};
+
+/**
+ * \brief trace_sink implementation that forwards to session::s_get() in the module it's compiled into.
+ *
+ * Hosts collecting traces from all modules should register this:
+ *
+ * \code{.cpp}
+ * service_factory_single_t<uie::tracing::session_trace_sink> g_session_trace_sink;
+ * \endcode
+ *
+ * Other components must not register it.
+ */
+class session_trace_sink : public trace_sink {
+public:
+    bool is_enabled() const override { return session::s_get().is_enabled(); }
+    int64_t get_elapsed_us() const override { return session::s_get().get_elapsed_us(); }
+    void add_event(const event& event) override { session::s_get().add_event(event); }
+    bool has_panel_name(const GUID& panel_id) const override { return session::s_get().has_panel_name(panel_id); }
+
+    void set_panel_name(const GUID& panel_id, const char* name) override
+    {
+        session::s_get().set_panel_name(panel_id, name);
+    }
+};
+
+/**
+ * Get the trace sink used by scoped_trace.
+ *
+ * This is the trace_sink registered by the host if there is one, or a session_trace_sink for the session of this
+ * module otherwise.
+ */
+[[nodiscard]] trace_sink& get_trace_sink();
+
+/**
+ * \brief Traces an operation on a panel for the lifetime of this object.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * {
+ *     uie::tracing::scoped_trace trace(*panel, uie::tracing::operation_type::set_config);
+ *     panel->set_config_from_ptr(data, size, fb2k::noAbort);
+ * }
+ * \endcode
+ */
+class scoped_trace {
+public:
+    /**
+     * Trace an operation on a panel identified only by its GUID.
+     *
+     * The panel is shown by name only if its name has been recorded by another scoped_trace or by
+     * session::set_panel_name().
+     */
+    scoped_trace(const GUID& panel_id, operation_type type);
+
+    /** Trace an operation on a panel instance, recording its name if tracing is enabled. */
+    scoped_trace(const extension_base& panel, operation_type type);
+
+    ~scoped_trace();
+
+    scoped_trace(const scoped_trace&) = delete;
+    scoped_trace& operator=(const scoped_trace&) = delete;
+
+private:
+    void start(const GUID& panel_id, operation_type type);
+
+    std::optional<event> m_event;
+    int64_t m_start_private_bytes{};
+    int32_t m_start_gdi_objects{};
+    int32_t m_start_user_objects{};
+};
+
+/** Get the name of an operation type, e.g. `"set_config"`. */
+[[nodiscard]] const char* get_operation_type_name(operation_type type);
+
+} // namespace uie::tracing
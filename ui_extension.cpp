@@ -98,6 +98,14 @@ const GUID uie::window_host_with_control::class_guid
 const GUID uie::splitter_window_v3::class_guid
     = {0xbd79d2fe, 0xc21b, 0x4be0, {0x91, 0x7c, 0xf4, 0xce, 0x69, 0xc0, 0x03, 0x11}};
 
+const GUID uie::window_v2::class_guid = {0xef9f184d, 0x58bb, 0x481c, {0x8a, 0x06, 0xbc, 0xa4, 0x56, 0x52, 0xf4, 0xad}};
+
+const GUID uie::visualisation_host_v2::class_guid
+    = {0x2177b923, 0x6f54, 0x4443, {0xb5, 0x1b, 0xf0, 0x68, 0x79, 0x08, 0x7e, 0xbe}};
+
+const GUID uie::visualisation_v2::class_guid
+    = {0x88457b99, 0x35d8, 0x4d73, {0xa0, 0xeb, 0x36, 0x7c, 0x52, 0xcf, 0x40, 0x89}};
+
 HWND uFindParentPopup(HWND wnd_child)
 {
     HWND wnd_temp = _GetParent(wnd_child);
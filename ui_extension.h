@@ -8,12 +8,25 @@
 #endif
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 // Included first, because pfc.h includes winsock2.h
 #include "../pfc/pfc.h"
@@ -30,6 +43,7 @@
 #include "../foobar2000/SDK/initquit.h"
 #include "../foobar2000/SDK/titleformat.h"
 #include "../foobar2000/SDK/ui.h"
+#include "../foobar2000/SDK/vis.h"
 
 class stream_writer_memblock_ref : public stream_writer {
 public:
@@ -121,17 +135,22 @@ enum resize_flag_t {
 };
 
 class visualisation;
+class visualisation_v2;
 class visualisation_host;
+class visualisation_host_v2;
 
 typedef visualisation visualization;
 
 typedef service_ptr_t<class visualisation> visualisation_ptr;
+typedef service_ptr_t<class visualisation_v2> visualisation_v2_ptr;
 typedef service_ptr_t<class visualisation_host> visualisation_host_ptr;
+typedef service_ptr_t<class visualisation_host_v2> visualisation_host_v2_ptr;
 
 typedef visualisation_ptr visualization_ptr;
 typedef visualisation_host_ptr visualization_host_ptr;
 
 typedef service_ptr_t<class window> window_ptr;
+typedef service_ptr_t<class window_v2> window_v2_ptr;
 typedef service_ptr_t<class window_host> window_host_ptr;
 
 typedef service_ptr_t<class splitter_window> splitter_window_ptr;
@@ -151,23 +170,46 @@ namespace ui_extension = uie;
 #include "base.h"
 #include "window.h"
 #include "win32_helpers.h"
+#include "retained_bitmap.h"
 #include "window_helper.h"
+#include "tracing.h"
+#include "message_map.h"
 #include "container_window_v3.h"
 #include "container_uie_window_v3.h"
 #include "splitter.h"
+#include "deferred_window.h"
 #include "visualisation.h"
+#include "visualisation_frame_scheduler.h"
+#include "visualisation_painter.h"
+#include "audio_analysis.h"
+#include "spectrum_kernels.h"
 #include "buttons.h"
+#include "callback_list.h"
 #include "callback.h"
+#include "shared_cache_base.h"
 #include "columns_ui.h"
 #include "colours.h"
+#include "colour_snapshot.h"
+#include "gdi_object_cache.h"
 #include "fonts.h"
+#include "background_cache.h"
+#include "visualisation_background_cache.h"
+#include "button_image_atlas.h"
+#include "button_state_aggregator.h"
 
 #if CUI_SDK_DWRITE_ENABLED
 #include "dwrite_utils.h"
 #include "font_manager_v3.h"
+#include "text_format_cache.h"
+#include "text_layout_cache.h"
+#include "font_fallback_cache.h"
 #endif
 
 #include "font_utils.h"
+#include "font_handle_cache.h"
+#include "font_scaling.h"
+#include "log_font_cache.h"
+#include "appearance_change_hub.h"
 #include "panel_utils.h"
 
 namespace ui_extension = uie;
@@ -38,6 +38,72 @@ public:
     FB2K_MAKE_SERVICE_INTERFACE_ENTRYPOINT(visualisation_host);
 };
 
+/**
+ * \brief Frame pacing state of a visualisation host.
+ *
+ * \see visualisation_host_v2
+ */
+enum class frame_pacing_state {
+    /** Frames should be rendered at the normal rate. */
+    normal,
+    /** Frames should be rendered at a reduced rate, for example because the system is saving power. */
+    throttled,
+    /** The visualisation is hidden or fully covered, and frames should not be rendered. */
+    paused,
+};
+
+/**
+ * \brief Extends uie::visualisation_host, adding frame pacing.
+ *
+ * Visualisations should call is_frame_due() before calling create_painter(), and skip the frame if it returns
+ * false. This stops visualisations rendering frames that won't be seen, and aligns frames to the refresh rate of
+ * the display.
+ *
+ * uie::visualisation_frame_scheduler can be used to implement this interface.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * void my_visualisation::on_timer()
+ * {
+ *     uie::visualisation_host_v2_ptr host_v2;
+ *     if (m_host->service_query_t(host_v2) && !host_v2->is_frame_due())
+ *         return;
+ *
+ *     uie::visualisation_host::painter_ptr painter;
+ *     m_host->create_painter(painter);
+ *     // ...
+ * }
+ * \endcode
+ */
+class NOVTABLE visualisation_host_v2 : public visualisation_host {
+public:
+    /**
+     * \brief Get whether a frame should be rendered now.
+     *
+     * \return whether the visualisation should create a painter and render a frame
+     */
+    virtual bool is_frame_due() = 0;
+
+    /**
+     * \brief Get the current frame pacing state.
+     *
+     * Visualisations can use this to, for example, stop timers while paused.
+     */
+    virtual frame_pacing_state get_frame_pacing_state() = 0;
+
+    /**
+     * \brief Get the target interval between frames.
+     *
+     * This is a whole multiple of the refresh period of the display. Visualisations that use a timer to render
+     * frames should use an interval no longer than this.
+     *
+     * \return target interval between frames, in microseconds
+     */
+    virtual uint32_t get_frame_interval_us() = 0;
+
+    FB2K_MAKE_SERVICE_INTERFACE(visualisation_host_v2, visualisation_host);
+};
+
 /**
  * \brief Service factory for vis extension hosts.
  *
@@ -67,6 +133,8 @@ public:
 
     /**
      * \brief Paints the standard background of your visualisation.
+     *
+     * \see visualisation_v2 for allowing hosts to cache the background.
      */
     virtual void paint_background(HDC dc, const RECT* rc_area) = 0;
 
@@ -97,6 +165,39 @@ public:
     FB2K_MAKE_SERVICE_INTERFACE_ENTRYPOINT(visualisation);
 };
 
+/**
+ * \brief Extends uie::visualisation, allowing the background to be cached.
+ *
+ * By implementing this interface, a visualisation indicates that what paint_background() renders depends only on
+ * the size of the area, Columns UI colours, whether dark mode is active and the value returned by
+ * get_background_version().
+ *
+ * Hosts can then render the background once into a retained bitmap and copy it, rather than calling
+ * paint_background() every time. Visualisations can similarly cache the background they draw before each frame.
+ * uie::visualisation_background_cache can be used to do this.
+ */
+class NOVTABLE visualisation_v2 : public visualisation {
+public:
+    /**
+     * \brief Get whether the output of paint_background() can currently be cached.
+     *
+     * \return whether the background can be cached
+     */
+    virtual bool is_background_cacheable() { return true; }
+
+    /**
+     * \brief Get the version of the background.
+     *
+     * Return a different value whenever the background changes for a reason other than a change in size, Columns UI
+     * colours or dark mode status (for example, because a setting of the visualisation changed).
+     *
+     * \return background version
+     */
+    virtual uint32_t get_background_version() { return 0; }
+
+    FB2K_MAKE_SERVICE_INTERFACE(visualisation_v2, visualisation);
+};
+
 /**
  * \brief Service factory for vis extensions.
  * \par Usage example
@@ -0,0 +1,59 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+visualisation_background_cache::visualisation_background_cache(render_background_t render_background)
+    : m_render_background(std::move(render_background))
+{
+    if (fb2k::std_api_try_get(m_colours_api))
+        m_colours_api->register_common_callback(this);
+}
+
+visualisation_background_cache::~visualisation_background_cache()
+{
+    if (m_colours_api.is_valid())
+        m_colours_api->deregister_common_callback(this);
+
+    release_bitmap();
+}
+
+bool visualisation_background_cache::paint(HDC dc, const RECT& rect, uint32_t version)
+{
+    const SIZE size{rect.right - rect.left, rect.bottom - rect.top};
+
+    if (size.cx <= 0 || size.cy <= 0)
+        return false;
+
+    if (!m_is_valid || version != m_version || !m_bitmap.is_size(size)) {
+        m_version = version;
+
+        if (!render(dc, rect))
+            return false;
+    }
+
+    return BitBlt(dc, rect.left, rect.top, size.cx, size.cy, m_bitmap.get_dc(), 0, 0, SRCCOPY) != 0;
+}
+
+bool visualisation_background_cache::render(HDC dc, const RECT& rect)
+{
+    if (!m_bitmap.create(dc, {rect.right - rect.left, rect.bottom - rect.top})) {
+        m_is_valid = false;
+        return false;
+    }
+
+    const auto bitmap_dc = m_bitmap.get_dc();
+
+    // Offset the viewport so that the background is rendered using the same coordinates as the target
+    SetViewportOrgEx(bitmap_dc, -rect.left, -rect.top, nullptr);
+
+    if (m_render_background)
+        m_render_background(bitmap_dc, rect);
+
+    SetViewportOrgEx(bitmap_dc, 0, 0, nullptr);
+
+    ++m_render_count;
+    m_is_valid = true;
+    return true;
+}
+
+} // namespace uie
@@ -0,0 +1,95 @@
+#pragma once
+
+namespace uie {
+
+/**
+ * \brief Caches the background of a visualisation in a retained bitmap.
+ *
+ * The background is rendered when it's first painted, and then re-rendered only when the size of the area changes,
+ * when Columns UI colours or the dark mode status change, when the background version changes or when invalidate()
+ * is called. Otherwise, paint() copies the retained bitmap.
+ *
+ * This can be used by visualisation hosts to cache the output of visualisation::paint_background() (when the
+ * visualisation implements uie::visualisation_v2 and its background is cacheable), or by visualisations to cache
+ * the background drawn before each frame.
+ *
+ * \note This class must only be used from the main thread.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * // In a visualisation host
+ * uie::visualisation_background_cache m_background_cache{
+ *     [this](HDC dc, const RECT& rect) { m_visualisation->paint_background(dc, &rect); }};
+ *
+ * void my_visualisation_host::paint_background(HDC dc, const RECT& rect)
+ * {
+ *     uie::visualisation_v2_ptr visualisation_v2;
+ *
+ *     if (m_visualisation->service_query_t(visualisation_v2) && visualisation_v2->is_background_cacheable())
+ *         m_background_cache.paint(dc, rect, visualisation_v2->get_background_version());
+ *     else
+ *         m_visualisation->paint_background(dc, &rect);
+ * }
+ * \endcode
+ */
+class visualisation_background_cache final : cui::colours::common_callback {
+public:
+    /**
+     * Function used to render the background.
+     *
+     * \param dc    device context to render the background to
+     * \param rect  area to render the background in
+     */
+    using render_background_t = std::function<void(HDC dc, const RECT& rect)>;
+
+    /**
+     * \param render_background  function used to render the background
+     */
+    explicit visualisation_background_cache(render_background_t render_background);
+    ~visualisation_background_cache();
+
+    visualisation_background_cache(const visualisation_background_cache&) = delete;
+    visualisation_background_cache& operator=(const visualisation_background_cache&) = delete;
+
+    /**
+     * Paint the background, rendering it first if the cached background is out of date.
+     *
+     * \param dc       device context to paint to
+     * \param rect     area to paint the background in
+     * \param version  version of the background; it's re-rendered when this changes
+     * \return         whether the background was painted
+     */
+    bool paint(HDC dc, const RECT& rect, uint32_t version = 0);
+
+    /** Discard the cached background, so that it's re-rendered the next time it's painted. */
+    void invalidate() const { m_is_valid = false; }
+
+    /** Free the retained bitmap. It's recreated the next time the background is painted. */
+    void release_bitmap()
+    {
+        m_bitmap.release();
+        m_is_valid = false;
+    }
+
+    /** Get the number of times the background has been rendered. */
+    [[nodiscard]] uint64_t get_render_count() const { return m_render_count; }
+
+private:
+    void on_colour_changed(uint32_t changed_items_mask) const override { invalidate(); }
+    void on_bool_changed(uint32_t changed_items_mask) const override
+    {
+        if (changed_items_mask & cui::colours::bool_flag_dark_mode_enabled)
+            invalidate();
+    }
+
+    bool render(HDC dc, const RECT& rect);
+
+    win32::retained_bitmap m_bitmap;
+    uint32_t m_version{};
+    uint64_t m_render_count{};
+    mutable bool m_is_valid{};
+    render_background_t m_render_background;
+    cui::colours::manager::ptr m_colours_api;
+};
+
+} // namespace uie
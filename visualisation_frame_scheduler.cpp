@@ -0,0 +1,271 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+namespace {
+
+bool is_window_cloaked(HWND wnd)
+{
+    using dwm_get_window_attribute_t = HRESULT(WINAPI*)(HWND, DWORD, PVOID, DWORD);
+
+    // Loaded dynamically so that users of the SDK don't need to link to dwmapi.lib
+    static const auto dwm_get_window_attribute = []() -> dwm_get_window_attribute_t {
+        const auto module = LoadLibraryExW(L"dwmapi.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32);
+
+        if (!module)
+            return nullptr;
+
+        return reinterpret_cast<dwm_get_window_attribute_t>(GetProcAddress(module, "DwmGetWindowAttribute"));
+    }();
+
+    // DWMWA_CLOAKED
+    constexpr DWORD cloaked_attribute = 14;
+
+    DWORD cloaked{};
+    return dwm_get_window_attribute
+        && SUCCEEDED(dwm_get_window_attribute(wnd, cloaked_attribute, &cloaked, sizeof(cloaked))) && cloaked != 0;
+}
+
+bool does_rect_contain(const RECT& outer, const RECT& inner)
+{
+    return inner.left >= outer.left && inner.top >= outer.top && inner.right <= outer.right
+        && inner.bottom <= outer.bottom;
+}
+
+/**
+ * Check whether a window can't currently be seen.
+ *
+ * Only checks whether a single window completely covers the window. This handles the common case of a maximised
+ * window being in front, without needing to combine the areas of all windows in front.
+ */
+bool is_window_occluded(HWND wnd)
+{
+    if (!IsWindowVisible(wnd))
+        return true;
+
+    const auto root = GetAncestor(wnd, GA_ROOT);
+
+    if (IsIconic(root) || is_window_cloaked(root))
+        return true;
+
+    RECT client_rect{};
+    GetClientRect(wnd, &client_rect);
+    MapWindowPoints(wnd, HWND_DESKTOP, reinterpret_cast<LPPOINT>(&client_rect), 2);
+
+    const RECT virtual_screen_rect{GetSystemMetrics(SM_XVIRTUALSCREEN), GetSystemMetrics(SM_YVIRTUALSCREEN),
+        GetSystemMetrics(SM_XVIRTUALSCREEN) + GetSystemMetrics(SM_CXVIRTUALSCREEN),
+        GetSystemMetrics(SM_YVIRTUALSCREEN) + GetSystemMetrics(SM_CYVIRTUALSCREEN)};
+
+    RECT visible_rect{};
+    if (!IntersectRect(&visible_rect, &client_rect, &virtual_screen_rect))
+        return true;
+
+    for (auto other_wnd = GetWindow(root, GW_HWNDPREV); other_wnd; other_wnd = GetWindow(other_wnd, GW_HWNDPREV)) {
+        if (!IsWindowVisible(other_wnd) || IsIconic(other_wnd))
+            continue;
+
+        const auto ex_style = GetWindowLongPtr(other_wnd, GWL_EXSTYLE);
+
+        if (ex_style & (WS_EX_LAYERED | WS_EX_TRANSPARENT))
+            continue;
+
+        RECT other_rect{};
+        if (GetWindowRect(other_wnd, &other_rect) && does_rect_contain(other_rect, visible_rect)
+            && !is_window_cloaked(other_wnd))
+            return true;
+    }
+
+    return false;
+}
+
+bool is_battery_saver_on()
+{
+    SYSTEM_POWER_STATUS status{};
+    return GetSystemPowerStatus(&status) && status.SystemStatusFlag == 1;
+}
+
+std::optional<uint64_t> get_thread_cycle_time()
+{
+    ULONG64 cycles{};
+
+    if (!QueryThreadCycleTime(GetCurrentThread(), &cycles))
+        return {};
+
+    return cycles;
+}
+
+} // namespace
+
+void visualisation_frame_scheduler::set_window(HWND wnd)
+{
+    m_wnd = wnd;
+    invalidate_refresh_rate();
+}
+
+void visualisation_frame_scheduler::set_config(const visualisation_frame_scheduler_config& config)
+{
+    m_config = config;
+    m_next_frame_time.reset();
+}
+
+void visualisation_frame_scheduler::set_visible(bool is_visible)
+{
+    m_is_visible = is_visible;
+    m_last_occlusion_check.reset();
+}
+
+void visualisation_frame_scheduler::set_throttled(bool is_throttled)
+{
+    m_is_throttled_by_host = is_throttled;
+}
+
+bool visualisation_frame_scheduler::is_frame_due()
+{
+    const auto now = clock::now();
+    update(now);
+
+    if (m_state == frame_pacing_state::paused)
+        return false;
+
+    if (!m_next_frame_time)
+        return true;
+
+    // Timers aren't precise, so frames can start up to half a refresh period early
+    const auto tolerance = std::chrono::microseconds(500'000 / m_refresh_rate);
+    return now + tolerance >= *m_next_frame_time;
+}
+
+frame_pacing_state visualisation_frame_scheduler::get_state()
+{
+    update(clock::now());
+    return m_state;
+}
+
+uint32_t visualisation_frame_scheduler::get_frame_interval_us()
+{
+    update(clock::now());
+
+    if (m_state == frame_pacing_state::paused)
+        return 0;
+
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(get_frame_interval()).count());
+}
+
+void visualisation_frame_scheduler::begin_frame()
+{
+    const auto now = clock::now();
+    update(now);
+
+    m_frame_start_cycles = get_thread_cycle_time();
+
+    const auto interval = get_frame_interval();
+
+    if (!m_next_frame_time) {
+        m_next_frame_time = now + interval;
+        return;
+    }
+
+    const auto frame_time = *m_next_frame_time;
+    const auto tolerance = std::chrono::microseconds(500'000 / m_refresh_rate);
+
+    // Frames started well before the next slot (e.g. to repaint after a resize) don't use up the slot
+    if (now + tolerance < frame_time)
+        return;
+
+    const auto missed_frame_count = now > frame_time ? (now - frame_time) / interval : 0;
+
+    m_stats.dropped_frame_count += static_cast<uint64_t>(missed_frame_count);
+    m_next_frame_time = frame_time + interval * (missed_frame_count + 1);
+}
+
+void visualisation_frame_scheduler::end_frame()
+{
+    if (!m_frame_start_cycles)
+        return;
+
+    const auto end_cycles = get_thread_cycle_time();
+    const auto frame_cycles = end_cycles ? *end_cycles - *m_frame_start_cycles : 0;
+    m_frame_start_cycles.reset();
+
+    ++m_stats.frame_count;
+    m_stats.last_frame_cpu_cycles = frame_cycles;
+    m_stats.max_frame_cpu_cycles = std::max(m_stats.max_frame_cpu_cycles, frame_cycles);
+
+    // Exponential moving average, weighting the latest frame at 1/16
+    if (m_stats.frame_count == 1)
+        m_stats.average_frame_cpu_cycles = frame_cycles;
+    else
+        m_stats.average_frame_cpu_cycles
+            = m_stats.average_frame_cpu_cycles - m_stats.average_frame_cpu_cycles / 16 + frame_cycles / 16;
+}
+
+visualisation_frame_scheduler_stats visualisation_frame_scheduler::get_stats() const
+{
+    auto stats = m_stats;
+    stats.refresh_rate = m_refresh_rate;
+    return stats;
+}
+
+void visualisation_frame_scheduler::update(clock::time_point now)
+{
+    if (!m_last_occlusion_check || now - *m_last_occlusion_check >= m_config.occlusion_check_interval) {
+        m_last_occlusion_check = now;
+        m_is_occluded = m_wnd && is_window_occluded(m_wnd);
+        m_is_power_saving = is_battery_saver_on();
+
+        if (m_wnd) {
+            if (const auto monitor = MonitorFromWindow(m_wnd, MONITOR_DEFAULTTONEAREST); monitor != m_monitor)
+                update_refresh_rate(monitor);
+        }
+    }
+
+    auto state = frame_pacing_state::normal;
+
+    if (!m_is_visible || m_is_occluded)
+        state = frame_pacing_state::paused;
+    else if (m_is_throttled_by_host || m_is_power_saving)
+        state = frame_pacing_state::throttled;
+
+    if (state != m_state) {
+        m_state = state;
+        // Start a new schedule, so that time spent paused or at another rate doesn't count as dropped frames
+        m_next_frame_time.reset();
+    }
+}
+
+void visualisation_frame_scheduler::update_refresh_rate(HMONITOR monitor)
+{
+    m_monitor = monitor;
+
+    MONITORINFOEXW monitor_info{};
+    monitor_info.cbSize = sizeof(monitor_info);
+
+    DEVMODEW device_mode{};
+    device_mode.dmSize = sizeof(device_mode);
+
+    // Frequencies of 0 and 1 mean the hardware default
+    if (GetMonitorInfoW(monitor, &monitor_info)
+        && EnumDisplaySettingsW(monitor_info.szDevice, ENUM_CURRENT_SETTINGS, &device_mode)
+        && device_mode.dmDisplayFrequency > 1)
+        m_refresh_rate = device_mode.dmDisplayFrequency;
+    else
+        m_refresh_rate = 60;
+
+    m_next_frame_time.reset();
+}
+
+visualisation_frame_scheduler::clock::duration visualisation_frame_scheduler::get_frame_interval() const
+{
+    const auto max_frame_rate
+        = m_state == frame_pacing_state::throttled ? m_config.throttled_frame_rate : m_config.max_frame_rate;
+
+    // Use a whole number of refresh periods per frame, without exceeding the maximum frame rate
+    const auto refresh_periods_per_frame = max_frame_rate == 0 || max_frame_rate >= m_refresh_rate
+        ? 1u
+        : (m_refresh_rate + max_frame_rate - 1) / max_frame_rate;
+
+    const auto refresh_period = std::chrono::nanoseconds(1'000'000'000 / m_refresh_rate);
+    return std::chrono::duration_cast<clock::duration>(refresh_period * refresh_periods_per_frame);
+}
+
+} // namespace uie
@@ -0,0 +1,172 @@
+#pragma once
+
+namespace uie {
+
+/**
+ * \brief Configuration for visualisation_frame_scheduler.
+ */
+struct visualisation_frame_scheduler_config {
+    /** Maximum frame rate while in the normal state. 0 means the refresh rate of the display. */
+    uint32_t max_frame_rate{60};
+
+    /** Maximum frame rate while throttled. */
+    uint32_t throttled_frame_rate{15};
+
+    /** Minimum time between checks of whether the window is covered, minimised or on another monitor. */
+    std::chrono::milliseconds occlusion_check_interval{250};
+};
+
+/**
+ * \brief Frame pacing statistics for a visualisation host.
+ */
+struct visualisation_frame_scheduler_stats {
+    /** Number of frames rendered. */
+    uint64_t frame_count{};
+
+    /** Number of frame slots missed because a frame was rendered late. Time spent paused is not counted. */
+    uint64_t dropped_frame_count{};
+
+    /** CPU cycles used by the thread while rendering the last frame. */
+    uint64_t last_frame_cpu_cycles{};
+
+    /** Moving average of the CPU cycles used by the thread per frame. */
+    uint64_t average_frame_cpu_cycles{};
+
+    /** Maximum CPU cycles used by the thread for a frame. */
+    uint64_t max_frame_cpu_cycles{};
+
+    /** Refresh rate of the display the window is on, in Hz. */
+    uint32_t refresh_rate{};
+};
+
+/**
+ * \brief Helper for implementing visualisation_host_v2.
+ *
+ * Pauses rendering while the window is hidden, minimised, cloaked or completely covered by another window, and
+ * throttles rendering while the host requests it or Windows battery saver is on. Frames are scheduled at a whole
+ * multiple of the refresh period of the display the window is on.
+ *
+ * Frames are counted by calling begin_frame() and end_frame(). When used with
+ * double_buffered_visualisation_painter::set_frame_scheduler(), this is done automatically.
+ *
+ * \note This class must only be used from the thread that owns the window.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * class my_visualisation_host : public uie::visualisation_host_v2 {
+ * public:
+ *     void create_painter(painter_ptr& p_out) override { m_painter.create_painter(p_out); }
+ *     bool is_frame_due() override { return m_scheduler.is_frame_due(); }
+ *     uie::frame_pacing_state get_frame_pacing_state() override { return m_scheduler.get_state(); }
+ *     uint32_t get_frame_interval_us() override { return m_scheduler.get_frame_interval_us(); }
+ *
+ *     uie::visualisation_frame_scheduler m_scheduler;
+ *     uie::double_buffered_visualisation_painter m_painter;
+ * };
+ *
+ * // After creating the window
+ * m_scheduler.set_window(wnd);
+ * m_painter.set_window(wnd);
+ * m_painter.set_frame_scheduler(&m_scheduler);
+ *
+ * // Window procedure
+ * case WM_WINDOWPOSCHANGED:
+ *     m_scheduler.invalidate_occlusion();
+ *     break;
+ * case WM_DISPLAYCHANGE:
+ *     m_scheduler.invalidate_refresh_rate();
+ *     break;
+ * \endcode
+ */
+class visualisation_frame_scheduler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit visualisation_frame_scheduler(HWND wnd = nullptr, visualisation_frame_scheduler_config config = {})
+        : m_wnd(wnd)
+        , m_config(config)
+    {
+    }
+
+    /**
+     * Set the window frames are rendered to.
+     *
+     * \param wnd  the window
+     */
+    void set_window(HWND wnd);
+
+    void set_config(const visualisation_frame_scheduler_config& config);
+    [[nodiscard]] const visualisation_frame_scheduler_config& get_config() const { return m_config; }
+
+    /**
+     * Set whether the host is showing the visualisation.
+     *
+     * Hosts should call this when, for example, the visualisation is in a hidden splitter item or tab.
+     *
+     * \param is_visible  whether the visualisation is shown
+     */
+    void set_visible(bool is_visible);
+
+    /**
+     * Set whether the host wants frames to be rendered at a reduced rate.
+     *
+     * \param is_throttled  whether to throttle rendering
+     */
+    void set_throttled(bool is_throttled);
+
+    /** Check whether the window is covered or minimised on the next call, rather than after the usual interval. */
+    void invalidate_occlusion() { m_last_occlusion_check.reset(); }
+
+    /** Query the refresh rate of the display again on the next call, e.g. in response to `WM_DISPLAYCHANGE`. */
+    void invalidate_refresh_rate()
+    {
+        m_monitor = nullptr;
+        m_last_occlusion_check.reset();
+    }
+
+    /**
+     * Get whether a frame should be rendered now.
+     *
+     * \return false if paused, or if the next frame slot has not been reached
+     */
+    [[nodiscard]] bool is_frame_due();
+
+    [[nodiscard]] frame_pacing_state get_state();
+
+    /**
+     * Get the target interval between frames.
+     *
+     * \return interval, in microseconds, or 0 while paused
+     */
+    [[nodiscard]] uint32_t get_frame_interval_us();
+
+    /** Call when rendering of a frame starts. */
+    void begin_frame();
+
+    /** Call when rendering of a frame ends. */
+    void end_frame();
+
+    [[nodiscard]] visualisation_frame_scheduler_stats get_stats() const;
+    void reset_stats() { m_stats = {}; }
+
+private:
+    void update(clock::time_point now);
+    void update_refresh_rate(HMONITOR monitor);
+    [[nodiscard]] clock::duration get_frame_interval() const;
+
+    HWND m_wnd{};
+    visualisation_frame_scheduler_config m_config;
+    bool m_is_visible{true};
+    bool m_is_throttled_by_host{};
+    bool m_is_occluded{};
+    bool m_is_power_saving{};
+    HMONITOR m_monitor{};
+    uint32_t m_refresh_rate{60};
+    frame_pacing_state m_state{frame_pacing_state::normal};
+    std::optional<clock::time_point> m_last_occlusion_check;
+    std::optional<clock::time_point> m_next_frame_time;
+    std::optional<uint64_t> m_frame_start_cycles;
+    visualisation_frame_scheduler_stats m_stats;
+};
+
+} // namespace uie
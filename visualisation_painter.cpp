@@ -0,0 +1,198 @@
+#include "ui_extension.h"
+
+namespace uie {
+
+namespace {
+
+int64_t to_microseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+// Exponential moving average, weighting the latest sample at 1/16
+int64_t update_average(int64_t average, int64_t sample, uint64_t sample_count)
+{
+    if (sample_count <= 1)
+        return sample;
+
+    return average + (sample - average) / 16;
+}
+
+} // namespace
+
+class double_buffered_visualisation_painter::painter : public visualisation_host::painter_t {
+public:
+    explicit painter(double_buffered_visualisation_painter& owner) : m_owner(owner) { m_owner.begin_paint(); }
+    ~painter() override { m_owner.end_paint(); }
+
+    HDC get_device_context() const override { return m_owner.m_buffer.get_dc(); }
+    const RECT* get_area() const override { return &m_owner.m_area; }
+
+    // Painters are allocated once per frame, so freed painters are kept for reuse
+    static void* operator new(size_t size)
+    {
+        auto& free_list = s_free_list.items;
+
+        if (size == sizeof(painter) && !free_list.empty()) {
+            const auto item = free_list.back();
+            free_list.pop_back();
+            return item;
+        }
+
+        return ::operator new(size);
+    }
+
+    static void operator delete(void* item, size_t size)
+    {
+        auto& free_list = s_free_list.items;
+
+        if (size == sizeof(painter) && free_list.size() < max_free_painters) {
+            try {
+                free_list.emplace_back(item);
+                return;
+            } catch (const std::bad_alloc&) {
+            }
+        }
+
+        ::operator delete(item);
+    }
+
+private:
+    struct free_list {
+        ~free_list()
+        {
+            for (const auto item : items)
+                ::operator delete(item);
+        }
+
+        std::vector<void*> items;
+    };
+
+    static constexpr size_t max_free_painters = 4;
+    inline static thread_local free_list s_free_list;
+
+    double_buffered_visualisation_painter& m_owner;
+};
+
+void double_buffered_visualisation_painter::set_window(HWND wnd)
+{
+    if (wnd == m_wnd)
+        return;
+
+    release_buffer();
+    m_wnd = wnd;
+}
+
+void double_buffered_visualisation_painter::set_area(const RECT& area)
+{
+    m_area = area;
+
+    if (!m_buffer.is_size({area.right - area.left, area.bottom - area.top}))
+        release_buffer();
+    else
+        SetViewportOrgEx(m_buffer.get_dc(), -m_area.left, -m_area.top, nullptr);
+}
+
+void double_buffered_visualisation_painter::create_painter(visualisation_host::painter_ptr& p_out)
+{
+    p_out = new painter(*this);
+}
+
+bool double_buffered_visualisation_painter::paint(HDC dc, const RECT& paint_rect) const
+{
+    const auto buffer_dc = m_buffer.get_dc();
+
+    if (!buffer_dc)
+        return false;
+
+    RECT rect{};
+    if (!IntersectRect(&rect, &paint_rect, &m_area))
+        return false;
+
+    // The viewport origin of the buffer is offset so that it uses the same coordinates as the window
+    return BitBlt(dc, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, buffer_dc, rect.left,
+               rect.top, SRCCOPY)
+        != 0;
+}
+
+void double_buffered_visualisation_painter::release_buffer()
+{
+    m_buffer.release();
+}
+
+bool double_buffered_visualisation_painter::create_buffer()
+{
+    const SIZE size{std::max(m_area.right - m_area.left, 1L), std::max(m_area.bottom - m_area.top, 1L)};
+
+    const auto wnd_dc = GetDC(m_wnd);
+    const auto is_buffer_created = m_buffer.create(wnd_dc, size, win32::retained_bitmap::bitmap_type::dib_section);
+    ReleaseDC(m_wnd, wnd_dc);
+
+    if (!is_buffer_created)
+        return false;
+
+    SetViewportOrgEx(m_buffer.get_dc(), -m_area.left, -m_area.top, nullptr);
+    return true;
+}
+
+void double_buffered_visualisation_painter::begin_paint()
+{
+    if (m_active_painter_count++ > 0)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    if (m_last_frame_start) {
+        const auto interval_us = to_microseconds(now - *m_last_frame_start);
+        m_frame_stats.average_frame_interval_us
+            = update_average(m_frame_stats.average_frame_interval_us, interval_us, m_frame_stats.frame_count);
+    }
+
+    m_last_frame_start = now;
+    m_paint_start = now;
+
+    if (m_frame_scheduler)
+        m_frame_scheduler->begin_frame();
+
+    if (!m_buffer.get_dc())
+        create_buffer();
+
+    if (const auto buffer_dc = m_buffer.get_dc())
+        SetBoundsRect(buffer_dc, nullptr, DCB_ENABLE | DCB_RESET);
+}
+
+void double_buffered_visualisation_painter::end_paint()
+{
+    if (--m_active_painter_count > 0)
+        return;
+
+    const auto is_paused = m_frame_scheduler && m_frame_scheduler->get_state() == frame_pacing_state::paused;
+
+    if (const auto buffer_dc = m_buffer.get_dc(); buffer_dc && m_wnd && !is_paused) {
+        RECT dirty_rect{};
+        const auto bounds_result = GetBoundsRect(buffer_dc, &dirty_rect, DCB_RESET);
+        SetBoundsRect(buffer_dc, nullptr, DCB_DISABLE);
+
+        if (bounds_result == DCB_SET && IntersectRect(&dirty_rect, &dirty_rect, &m_area)) {
+            const auto wnd_dc = GetDC(m_wnd);
+            paint(wnd_dc, dirty_rect);
+            ReleaseDC(m_wnd, wnd_dc);
+        }
+    }
+
+    if (m_paint_start) {
+        const auto paint_us = to_microseconds(std::chrono::steady_clock::now() - *m_paint_start);
+
+        ++m_frame_stats.frame_count;
+        m_frame_stats.last_paint_us = paint_us;
+        m_frame_stats.max_paint_us = std::max(m_frame_stats.max_paint_us, paint_us);
+        m_frame_stats.average_paint_us
+            = update_average(m_frame_stats.average_paint_us, paint_us, m_frame_stats.frame_count);
+        m_paint_start.reset();
+    }
+
+    if (m_frame_scheduler)
+        m_frame_scheduler->end_frame();
+}
+
+} // namespace uie
@@ -0,0 +1,124 @@
+#pragma once
+
+namespace uie {
+
+/**
+ * \brief Frame timing statistics for a visualisation host.
+ *
+ * Paint times are measured from the creation of a painter to its release. Frame intervals are measured between the
+ * creation of consecutive painters.
+ */
+struct visualisation_frame_stats {
+    uint64_t frame_count{};
+    int64_t last_paint_us{};
+    int64_t average_paint_us{};
+    int64_t max_paint_us{};
+    int64_t average_frame_interval_us{};
+};
+
+/**
+ * \brief Helper for implementing visualisation_host::create_painter() with a persistent off-screen buffer.
+ *
+ * Painters returned by create_painter() draw to a DIB section that is kept between frames and resized only when the
+ * area changes. When a painter is released, only the part of the buffer that was drawn to is copied to the window.
+ * Painter objects are recycled rather than being freed after each frame.
+ *
+ * As the buffer is persistent, the host can also repaint its window in response to `WM_PAINT` using paint(),
+ * without involving the visualisation.
+ *
+ * \note This class must only be used from the thread that owns the window.
+ *
+ * \par Usage example
+ * \code{.cpp}
+ * class my_visualisation_host : public uie::visualisation_host {
+ * public:
+ *     void create_painter(painter_ptr& p_out) override { m_painter.create_painter(p_out); }
+ *
+ *     uie::double_buffered_visualisation_painter m_painter;
+ * };
+ *
+ * // Window procedure
+ * case WM_SIZE:
+ *     m_painter.set_area(client_rect);
+ *     break;
+ * case WM_PAINT: {
+ *     PAINTSTRUCT ps;
+ *     const auto dc = BeginPaint(wnd, &ps);
+ *     m_painter.paint(dc, ps.rcPaint);
+ *     EndPaint(wnd, &ps);
+ *     return 0;
+ * }
+ * \endcode
+ */
+class double_buffered_visualisation_painter {
+public:
+    explicit double_buffered_visualisation_painter(HWND wnd = nullptr) : m_wnd(wnd) {}
+
+    double_buffered_visualisation_painter(const double_buffered_visualisation_painter&) = delete;
+    double_buffered_visualisation_painter& operator=(const double_buffered_visualisation_painter&) = delete;
+
+    /**
+     * Set the window painted to.
+     *
+     * \param wnd  the window
+     */
+    void set_window(HWND wnd);
+
+    /**
+     * Set the area of the window the visualisation is drawn in.
+     *
+     * \param area  area, in client coordinates of the window
+     */
+    void set_area(const RECT& area);
+
+    [[nodiscard]] const RECT& get_area() const { return m_area; }
+
+    /**
+     * Set a frame scheduler to notify when frames start and end.
+     *
+     * While the scheduler is paused, frames are still drawn to the buffer, but are not copied to the window.
+     *
+     * \param scheduler  the scheduler, or nullptr
+     */
+    void set_frame_scheduler(visualisation_frame_scheduler* scheduler) { m_frame_scheduler = scheduler; }
+
+    /**
+     * Create a painter. Intended to be called from visualisation_host::create_painter().
+     *
+     * \param p_out  receives the painter
+     */
+    void create_painter(visualisation_host::painter_ptr& p_out);
+
+    /**
+     * Copy the buffer to a device context, for example in response to `WM_PAINT`.
+     *
+     * \param dc          device context of the window
+     * \param paint_rect  area to paint, in client coordinates
+     * \return            whether anything was painted
+     */
+    bool paint(HDC dc, const RECT& paint_rect) const;
+
+    /** Free the off-screen buffer. It is recreated when the next painter is created. */
+    void release_buffer();
+
+    [[nodiscard]] visualisation_frame_stats get_frame_stats() const { return m_frame_stats; }
+    void reset_frame_stats() { m_frame_stats = {}; }
+
+private:
+    class painter;
+
+    bool create_buffer();
+    void begin_paint();
+    void end_paint();
+
+    HWND m_wnd{};
+    visualisation_frame_scheduler* m_frame_scheduler{};
+    RECT m_area{};
+    win32::retained_bitmap m_buffer;
+    size_t m_active_painter_count{};
+    std::optional<std::chrono::steady_clock::time_point> m_paint_start;
+    std::optional<std::chrono::steady_clock::time_point> m_last_frame_start;
+    visualisation_frame_stats m_frame_stats;
+};
+
+} // namespace uie
@@ -19,40 +19,149 @@ int message_box(HWND wnd, const TCHAR* text, const TCHAR* caption, UINT type)
 
 }; // namespace win32_helpers
 
-bool uRebar_InsertItem(HWND wnd, int n, uREBARBANDINFO* rbbi, bool insert)
-{
-    pfc::stringcvt::string_wide_from_utf8 text_utf16;
+namespace {
 
+REBARBANDINFOW make_rebar_band_info_w(const uREBARBANDINFO& rbbi, const wchar_t* text)
+{
     REBARBANDINFOW rbw{};
     rbw.cbSize = REBARBANDINFOW_V6_SIZE;
 
-    rbw.fMask = rbbi->fMask;
-    rbw.fStyle = rbbi->fStyle;
-    rbw.clrFore = rbbi->clrFore;
-    rbw.clrBack = rbbi->clrBack;
-
-    if (rbbi->fMask & RBBIM_TEXT) {
-        text_utf16.convert(rbbi->lpText);
-        rbw.lpText = const_cast<WCHAR*>(text_utf16.get_ptr());
-    }
-
-    rbw.iImage = rbbi->iImage;
-    rbw.hwndChild = rbbi->hwndChild;
-    rbw.cxMinChild = rbbi->cxMinChild;
-    rbw.cyMinChild = rbbi->cyMinChild;
-    rbw.cx = rbbi->cx;
-    rbw.hbmBack = rbbi->hbmBack;
-    rbw.wID = rbbi->wID;
+    rbw.fMask = rbbi.fMask;
+    rbw.fStyle = rbbi.fStyle;
+    rbw.clrFore = rbbi.clrFore;
+    rbw.clrBack = rbbi.clrBack;
+
+    if (rbbi.fMask & RBBIM_TEXT)
+        rbw.lpText = const_cast<WCHAR*>(text);
+
+    rbw.iImage = rbbi.iImage;
+    rbw.hwndChild = rbbi.hwndChild;
+    rbw.cxMinChild = rbbi.cxMinChild;
+    rbw.cyMinChild = rbbi.cyMinChild;
+    rbw.cx = rbbi.cx;
+    rbw.hbmBack = rbbi.hbmBack;
+    rbw.wID = rbbi.wID;
 #if (_WIN32_IE >= 0x0400) // we should check size of structure instead so keeping compatibility is possible, but
                           // whatever
-    rbw.cyChild = rbbi->cyChild;
-    rbw.cyMaxChild = rbbi->cyMaxChild;
-    rbw.cyIntegral = rbbi->cyIntegral;
-    rbw.cxIdeal = rbbi->cxIdeal;
-    rbw.lParam = rbbi->lParam;
-    rbw.cxHeader = rbbi->cxHeader;
+    rbw.cyChild = rbbi.cyChild;
+    rbw.cyMaxChild = rbbi.cyMaxChild;
+    rbw.cyIntegral = rbbi.cyIntegral;
+    rbw.cxIdeal = rbbi.cxIdeal;
+    rbw.lParam = rbbi.lParam;
+    rbw.cxHeader = rbbi.cxHeader;
 #endif
 
+    return rbw;
+}
+
+/**
+ * Suspends redrawing of a window while in scope, and repaints the window once afterwards.
+ *
+ * Does nothing for hidden windows, as re-enabling redraw would show them.
+ */
+class redraw_suspension {
+public:
+    explicit redraw_suspension(HWND wnd) : m_wnd(IsWindowVisible(wnd) ? wnd : nullptr)
+    {
+        if (m_wnd)
+            SendMessage(m_wnd, WM_SETREDRAW, FALSE, 0);
+    }
+
+    ~redraw_suspension()
+    {
+        if (!m_wnd)
+            return;
+
+        SendMessage(m_wnd, WM_SETREDRAW, TRUE, 0);
+        RedrawWindow(m_wnd, nullptr, nullptr, RDW_ERASE | RDW_FRAME | RDW_INVALIDATE | RDW_ALLCHILDREN);
+    }
+
+    redraw_suspension(const redraw_suspension&) = delete;
+    redraw_suspension& operator=(const redraw_suspension&) = delete;
+
+private:
+    HWND m_wnd{};
+};
+
+/**
+ * Converts multiple UTF-8 strings into one UTF-16 buffer, which is reused between calls on the same thread.
+ *
+ * Each string is null-terminated in the buffer. The returned offsets remain valid until the next call.
+ */
+class utf16_string_pool {
+public:
+    void clear()
+    {
+        m_buffer.clear();
+        m_offsets.clear();
+    }
+
+    void add(std::string_view text, bool escape_ampersands)
+    {
+        const auto offset = m_buffer.size();
+        const auto max_length = pfc::stringcvt::estimate_utf8_to_wide(text.data(), text.size());
+
+        m_buffer.resize(offset + max_length + 1);
+        const auto length = pfc::stringcvt::convert_utf8_to_wide(
+            m_buffer.data() + offset, max_length + 1, text.data(), text.size());
+        m_buffer.resize(offset + length);
+
+        if (escape_ampersands) {
+            const auto ampersand_count = std::count(m_buffer.begin() + offset, m_buffer.end(), L'&');
+
+            if (ampersand_count > 0) {
+                m_buffer.resize(m_buffer.size() + ampersand_count);
+
+                // Double each ampersand, working backwards so that characters are only moved once
+                auto source = offset + length;
+                auto destination = m_buffer.size();
+
+                while (source > offset) {
+                    const auto character = m_buffer[--source];
+                    m_buffer[--destination] = character;
+
+                    if (character == L'&')
+                        m_buffer[--destination] = L'&';
+                }
+            }
+        }
+
+        m_buffer.push_back(L'\0');
+        m_offsets.push_back(offset);
+    }
+
+    [[nodiscard]] const wchar_t* get(size_t index) const { return m_buffer.data() + m_offsets[index]; }
+
+private:
+    std::wstring m_buffer;
+    std::vector<size_t> m_offsets;
+};
+
+thread_local utf16_string_pool t_string_pool;
+
+/** Take the buffer for this thread, leaving an empty one in case the function is re-entered. */
+utf16_string_pool acquire_string_pool()
+{
+    auto string_pool = std::exchange(t_string_pool, {});
+    string_pool.clear();
+    return string_pool;
+}
+
+void release_string_pool(utf16_string_pool string_pool)
+{
+    t_string_pool = std::move(string_pool);
+}
+
+} // namespace
+
+bool uRebar_InsertItem(HWND wnd, int n, uREBARBANDINFO* rbbi, bool insert)
+{
+    pfc::stringcvt::string_wide_from_utf8 text_utf16;
+
+    if (rbbi->fMask & RBBIM_TEXT)
+        text_utf16.convert(rbbi->lpText);
+
+    auto rbw = make_rebar_band_info_w(*rbbi, text_utf16.get_ptr());
     return SendMessage(wnd, insert ? RB_INSERTBANDW : RB_SETBANDINFOW, n, reinterpret_cast<LPARAM>(&rbw)) != 0;
 }
 
@@ -207,6 +316,10 @@ namespace uie::win32 {
 LRESULT paint_background_using_parent(HWND wnd, HDC dc, bool use_wm_printclient)
 {
     const auto wnd_parent = GetParent(wnd);
+
+    if (background_cache::s_paint_child_background(wnd_parent, wnd, dc))
+        return TRUE;
+
     auto top_left = POINT{0, 0};
     auto previous_origin = POINT{};
 
@@ -221,6 +334,60 @@ LRESULT paint_background_using_parent(HWND wnd, HDC dc, bool use_wm_printclient)
     return SendMessage(wnd_parent, WM_ERASEBKGND, reinterpret_cast<WPARAM>(dc), 0);
 }
 
+size_t insert_rebar_bands(HWND wnd, int index, std::span<const uREBARBANDINFO> bands)
+{
+    auto string_pool = acquire_string_pool();
+
+    for (auto&& band : bands)
+        string_pool.add((band.fMask & RBBIM_TEXT) && band.lpText ? band.lpText : "", false);
+
+    size_t inserted_count{};
+
+    {
+        redraw_suspension suspension(wnd);
+
+        for (size_t band_index{}; band_index < bands.size(); ++band_index) {
+            auto rbw = make_rebar_band_info_w(bands[band_index], string_pool.get(band_index));
+            const auto insert_index = index < 0 ? -1 : index + static_cast<int>(inserted_count);
+
+            if (SendMessage(wnd, RB_INSERTBANDW, insert_index, reinterpret_cast<LPARAM>(&rbw)))
+                ++inserted_count;
+        }
+    }
+
+    release_string_pool(std::move(string_pool));
+    return inserted_count;
+}
+
+size_t insert_tab_items(HWND wnd, int index, std::span<const std::string_view> texts)
+{
+    auto string_pool = acquire_string_pool();
+
+    for (auto&& text : texts)
+        string_pool.add(text, true);
+
+    size_t inserted_count{};
+
+    {
+        redraw_suspension suspension(wnd);
+        const auto first_index = index < 0 ? TabCtrl_GetItemCount(wnd) : index;
+
+        for (size_t text_index{}; text_index < texts.size(); ++text_index) {
+            TCITEMW item{};
+            item.mask = TCIF_TEXT;
+            item.pszText = const_cast<wchar_t*>(string_pool.get(text_index));
+
+            const auto insert_index = first_index + static_cast<int>(inserted_count);
+
+            if (SendMessage(wnd, TCM_INSERTITEMW, insert_index, reinterpret_cast<LPARAM>(&item)) >= 0)
+                ++inserted_count;
+        }
+    }
+
+    release_string_pool(std::move(string_pool));
+    return inserted_count;
+}
+
 } // namespace uie::win32
 
 #endif
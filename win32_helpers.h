@@ -63,6 +63,47 @@ void send_message_to_direct_children(HWND wnd_parent, UINT msg, WPARAM wp, LPARA
 
 namespace uie::win32 {
 
+/**
+ * Paint the background of a window using its parent window's background.
+ *
+ * If a uie::win32::background_cache is attached to the parent window, the cached background is copied instead.
+ *
+ * \param wnd                 the window
+ * \param dc                  device context to paint to
+ * \param use_wm_printclient  whether to send `WM_PRINTCLIENT` rather than `WM_ERASEBKGND` to the parent window
+ */
 LRESULT paint_background_using_parent(HWND wnd, HDC dc, bool use_wm_printclient);
 
+/**
+ * Insert multiple bands into a rebar control.
+ *
+ * Unlike calling uRebar_InsertItem() for each band, the text of all bands is converted into a single reused UTF-16
+ * buffer, and the control is only repainted once, after all bands have been inserted.
+ *
+ * \note This only batches repainting. The rebar control still lays out its bands each time a band is inserted, so
+ *       the cost of inserting many bands still grows with the number of bands.
+ *
+ * \param wnd    the rebar control
+ * \param index  index to insert the first band at, or -1 to add the bands at the end
+ * \param bands  bands to insert; lpText is UTF-8 for bands with `RBBIM_TEXT` set
+ * \return       number of bands inserted
+ */
+size_t insert_rebar_bands(HWND wnd, int index, std::span<const uREBARBANDINFO> bands);
+
+/**
+ * Insert multiple tabs into a tab control.
+ *
+ * Ampersands in the text are escaped, as with uTabCtrl_InsertItemText(). Unlike calling uTabCtrl_InsertItemText()
+ * for each tab, the text of all tabs is converted into a single reused UTF-16 buffer, and the control is only
+ * repainted once, after all tabs have been inserted.
+ *
+ * \note This only batches repainting. The tab control still lays out its tabs each time a tab is inserted.
+ *
+ * \param wnd    the tab control
+ * \param index  index to insert the first tab at, or -1 to add the tabs at the end
+ * \param texts  UTF-8 text of the tabs
+ * \return       number of tabs inserted
+ */
+size_t insert_tab_items(HWND wnd, int index, std::span<const std::string_view> texts);
+
 }
@@ -284,6 +284,54 @@ public:
     FB2K_MAKE_SERVICE_INTERFACE_ENTRYPOINT(window);
 };
 
+/**
+ * \brief Subclass of uie::window, adding notifications for when the host hides or shows the window.
+ *
+ * Hidden windows (for example, in hidden or auto-hidden splitter items, or in inactive tabs) are not destroyed, and
+ * would otherwise continue to process callbacks, timers and repaints. Implement this interface to pause that work
+ * while the window is hidden.
+ *
+ * Hosts should query for this interface using `service_query_t()`, and call on_suspend() and on_resume() whenever
+ * they hide or show a hosted window. uie::utils::set_window_suspended() can be used to do this.
+ *
+ * \note Hosts that do not support this interface will not call these methods.
+ *
+ * \see uie::container_uie_window_v3_t
+ */
+class NOVTABLE window_v2 : public window {
+public:
+    /**
+     * \brief Called when the host has hidden the window.
+     *
+     * You should stop timers, stop processing callbacks that only update what's displayed, and stop repainting
+     * until on_resume() is called.
+     *
+     * \pre May only be called on hosted windows.
+     */
+    virtual void on_suspend() {}
+
+    /**
+     * \brief Called when the host has shown a previously hidden window.
+     *
+     * You should restart anything stopped in on_suspend(), and refresh anything that may have changed while the
+     * window was hidden.
+     *
+     * \pre May only be called on hosted windows.
+     */
+    virtual void on_resume() {}
+
+    /**
+     * \brief Called to request that the window releases any caches or other memory that it can recreate later.
+     *
+     * Hosts typically call this some time after suspending a window.
+     *
+     * \pre May only be called on hosted windows.
+     */
+    virtual void on_trim_memory() {}
+
+    FB2K_MAKE_SERVICE_INTERFACE(window_v2, window);
+};
+
 /**
  * \brief Subclass of uie::window, specifically for menu bars.
  */
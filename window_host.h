@@ -149,6 +149,10 @@ public:
     /**
      * \brief Hide or show a hosted window.
      *
+     * Implementers: If the hosted window implements uie::window_v2, call uie::window_v2::on_suspend() or
+     * uie::window_v2::on_resume() when the visibility of the window changes (whether through this method or
+     * otherwise). uie::utils::set_window_suspended() can be used to do this.
+     *
      * \param[in] wnd   handle to the window to test
      * \param[in] visibility   whether you want the window to be visible
      * \pre May only be called by a hosted window.